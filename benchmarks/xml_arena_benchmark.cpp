@@ -0,0 +1,78 @@
+// Parse and teardown time of XMLParser::parse with and without
+// XMLParseOptions::use_arena, on a generated document of records.
+//
+// Build and run from the repository root:
+//   g++ -std=c++17 -O2 -Iinclude benchmarks/xml_arena_benchmark.cpp src/parsers/*.cpp -pthread -o xml_arena_benchmark
+//   ./xml_arena_benchmark [records] [runs]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include "parsers/xml_parser.h"
+
+using namespace parser;
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    std::string make_document(size_t records) {
+        std::string xml = "<catalog>";
+        for (size_t i = 0; i < records; ++i) {
+            std::string id = std::to_string(i);
+            xml += "<item id=\"" + id + "\" status=\"active\">";
+            xml += "<name>Item number " + id + "</name>";
+            xml += "<description>A longer description of item " + id + ", so that the text does not fit a short string</description>";
+            xml += "<price currency=\"EUR\">" + std::to_string(i % 1000) + ".99</price>";
+            xml += "<tags><tag>alpha</tag><tag>beta</tag></tags>";
+            xml += "</item>";
+        }
+        xml += "</catalog>";
+        return xml;
+    }
+
+    double seconds_since(Clock::time_point start) {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    // Best of several runs, since the first run also warms up the allocator
+    void run(const char* label, const std::string& xml, bool use_arena, int runs) {
+        XMLParseOptions options;
+        options.use_arena = use_arena;
+        XMLParser parser(options);
+
+        double best_parse = 0.0;
+        double best_free = 0.0;
+        for (int i = 0; i < runs; ++i) {
+            Clock::time_point start = Clock::now();
+            auto* result = new XMLResult(parser.parse(xml));
+            double parse_time = seconds_since(start);
+            if (!result->success) {
+                std::cout << label << ": " << result->error_message << std::endl;
+                std::exit(1);
+            }
+
+            start = Clock::now();
+            delete result;
+            double free_time = seconds_since(start);
+
+            best_parse = i == 0 ? parse_time : std::min(best_parse, parse_time);
+            best_free = i == 0 ? free_time : std::min(best_free, free_time);
+        }
+        std::cout << label << ": parse " << best_parse * 1000.0 << " ms, free " << best_free * 1000.0 << " ms" << std::endl;
+    }
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t records = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+    int runs = argc > 2 ? std::atoi(argv[2]) : 5;
+
+    std::string xml = make_document(records);
+    std::cout << records << " records, " << xml.size() / (1024 * 1024) << " MB" << std::endl;
+    run("heap ", xml, false, runs);
+    run("arena", xml, true, runs);
+    return 0;
+}
@@ -3,6 +3,7 @@
 #include <string>
 #include <map>
 #include <vector>
+#include "parsers/parse_error.h"
 
 namespace parser {
 
@@ -12,6 +13,7 @@ namespace parser {
     struct INIResult {
         bool success = false;
         std::string error_message;
+        ErrorLocation error_location;
         std::map<std::string, std::map<std::string, std::string>> sections;
         
         /**
@@ -4,6 +4,7 @@
 #include <map>
 #include <vector>
 #include <variant>
+#include "parsers/parse_error.h"
 
 namespace parser {
 
@@ -36,6 +37,13 @@ namespace parser {
         JSONValue(double value) : type_(Type::Number), double_value_(value) {}
         JSONValue(bool value) : type_(Type::Boolean), bool_value_(value) {}
 
+        /**
+         * @brief Create an empty object or array value
+         * @param type Type::Object or Type::Array
+         * @return Empty container of the requested type
+         */
+        static JSONValue make(Type type);
+
         Type get_type() const { return type_; }
         
         std::string as_string() const;
@@ -45,18 +53,26 @@ namespace parser {
         
         // Object methods
         void set(const std::string& key, const JSONValue& value);
+        void set(const std::string& key, JSONValue&& value);
         JSONValue get(const std::string& key) const;
         bool has_key(const std::string& key) const;
         std::vector<std::string> get_keys() const;
         
         // Array methods
         void push_back(const JSONValue& value);
+        void push_back(JSONValue&& value);
         JSONValue at(size_t index) const;
         size_t size() const;
         bool is_array() const { return type_ == Type::Array; }
         bool is_object() const { return type_ == Type::Object; }
 
+        // Direct access to container storage
+        const std::map<std::string, JSONValue>& object_items() const { return object_values_; }
+        const std::vector<JSONValue>& array_items() const { return array_values_; }
+
     private:
+        friend class JSONParser;
+
         Type type_;
         std::string string_value_;
         int int_value_ = 0;
@@ -72,6 +88,7 @@ namespace parser {
     struct JSONResult {
         bool success = false;
         std::string error_message;
+        ErrorLocation error_location;
         JSONValue root;
         
         /**
@@ -153,6 +170,19 @@ namespace parser {
          * @return JSONResult with parsed data or error information
          */
         JSONResult parse_file(const std::string& filename);
+
+        /**
+         * @brief Parse a large JSON document using several threads
+         *
+         * The top-level array or object is split into balanced chunks at
+         * top-level commas, and the chunks are parsed concurrently. Other
+         * documents, and inputs too small to benefit, are parsed with parse().
+         *
+         * @param content The JSON content as string
+         * @param thread_count Number of threads, 0 for the hardware concurrency
+         * @return JSONResult with parsed data or error information
+         */
+        JSONResult parse_parallel(const std::string& content, size_t thread_count = 0);
         
         /**
          * @brief Convert parsed data back to JSON format
@@ -171,46 +201,99 @@ namespace parser {
          */
         bool save_to_file(const JSONResult& result, const std::string& filename, bool pretty_print = false);
 
+        /**
+         * @brief Parse CBOR (RFC 8949) encoded data
+         * @param data The binary CBOR content
+         * @return JSONResult with decoded data or error information
+         */
+        JSONResult parse_cbor(const std::string& data);
+
+        /**
+         * @brief Parse CBOR encoded data from file
+         * @param filename The path to the CBOR file
+         * @return JSONResult with decoded data or error information
+         */
+        JSONResult parse_cbor_file(const std::string& filename);
+
+        /**
+         * @brief Convert parsed data to CBOR binary format
+         * @param result The parsed JSON result
+         * @return CBOR encoded bytes
+         */
+        std::string to_cbor(const JSONResult& result);
+
+        /**
+         * @brief Save parsed data to file in CBOR format
+         * @param result The parsed JSON result
+         * @param filename The output file path
+         * @return True if successful
+         */
+        bool save_to_cbor_file(const JSONResult& result, const std::string& filename);
+
     private:
+        /**
+         * @brief Build an error status
+         * @param message The error description
+         * @return Failed status, so callers can write "return fail(...)"
+         */
+        static ParseStatus fail(const std::string& message);
+
         /**
          * @brief Parse JSON value from string
          * @param content The JSON content
          * @param pos Current position in the content
-         * @return Parsed JSON value
+         * @param value Receives the parsed value
+         * @return Empty status if successful, otherwise the error
          */
-        JSONValue parse_value(const std::string& content, size_t& pos);
+        ParseStatus parse_value(const std::string& content, size_t& pos, JSONValue& value);
         
         /**
          * @brief Parse JSON object from string
          * @param content The JSON content
          * @param pos Current position in the content
-         * @return Parsed JSON object
+         * @param obj Receives the parsed object
+         * @return Empty status if successful, otherwise the error
          */
-        JSONValue parse_object(const std::string& content, size_t& pos);
+        ParseStatus parse_object(const std::string& content, size_t& pos, JSONValue& obj);
         
         /**
          * @brief Parse JSON array from string
          * @param content The JSON content
          * @param pos Current position in the content
-         * @return Parsed JSON array
+         * @param arr Receives the parsed array
+         * @return Empty status if successful, otherwise the error
+         */
+        ParseStatus parse_array(const std::string& content, size_t& pos, JSONValue& arr);
+
+        /**
+         * @brief Parse the elements or members between two top-level delimiters
+         * @param content The JSON content
+         * @param pos Position of the opening delimiter ('[', '{' or ',')
+         * @param end Position of the closing delimiter (',', ']' or '}')
+         * @param keys Receives member keys when parsing an object
+         * @param values Receives the parsed values
+         * @return Empty status if successful, otherwise the error
          */
-        JSONValue parse_array(const std::string& content, size_t& pos);
+        ParseStatus parse_chunk(const std::string& content, size_t& pos, size_t end,
+                                std::vector<std::string>* keys, std::vector<JSONValue>& values);
         
         /**
          * @brief Parse JSON string from string
          * @param content The JSON content
          * @param pos Current position in the content
-         * @return Parsed string value
+         * @param result Receives the decoded string
+         * @return Empty status if successful, otherwise the error
          */
-        std::string parse_string(const std::string& content, size_t& pos);
+        ParseStatus parse_string(const std::string& content, size_t& pos, std::string& result);
         
         /**
          * @brief Parse JSON number from string
          * @param content The JSON content
          * @param pos Current position in the content
-         * @return Parsed number value
+         * @param value Receives the parsed number
+         * @return Empty status if successful, otherwise the error
          */
-        JSONValue parse_number(const std::string& content, size_t& pos);
+        ParseStatus parse_number(const std::string& content, size_t& pos, JSONValue& value);
         
         /**
          * @brief Skip whitespace characters
@@ -227,6 +310,23 @@ namespace parser {
          * @return String representation
          */
         std::string value_to_string(const JSONValue& value, int indent = 0, bool pretty_print = false);
+
+        /**
+         * @brief Append CBOR encoding of a JSON value
+         * @param value The JSON value to encode
+         * @param out Output buffer
+         */
+        void value_to_cbor(const JSONValue& value, std::string& out);
+
+        /**
+         * @brief Decode one CBOR data item
+         * @param data The CBOR content
+         * @param pos Current position in the content
+         * @param value Receives the decoded value
+         * @param depth Current nesting depth
+         * @return Empty status if successful, otherwise the error
+         */
+        ParseStatus parse_cbor_value(const std::string& data, size_t& pos, JSONValue& value, int depth = 0);
     };
 
 } // namespace parser 
\ No newline at end of file
@@ -0,0 +1,221 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <functional>
+#include <istream>
+#include "parsers/parse_error.h"
+#include "parsers/mapped_file.h"
+
+namespace parser {
+
+    /**
+     * @brief Streaming pull parser for JSON
+     *
+     * The reader walks the input one token at a time and never builds a
+     * tree. Keys, strings and numbers are returned as views that stay
+     * valid until the next call to next(); strings without escape
+     * sequences point into the input, others into an internal buffer.
+     * Memory use is bounded by the largest single token plus one read
+     * chunk, so documents far larger than memory can be processed.
+     *
+     * Input can be a memory-mapped file, a buffer owned by the caller, an
+     * input stream or a read callback delivering the input in chunks.
+     */
+    class JSONReader {
+    public:
+        enum class Event {
+            StartObject,
+            EndObject,
+            StartArray,
+            EndArray,
+            Key,
+            String,
+            Number,
+            Boolean,
+            Null,
+            EndDocument,
+            Error
+        };
+
+        /**
+         * @brief Callback reading the next chunk of input
+         *
+         * Receives a buffer and its size, returns the number of bytes
+         * written. Returning 0 signals the end of the input.
+         */
+        using ReadFunction = std::function<size_t(char* buffer, size_t size)>;
+
+        static constexpr size_t kDefaultChunkSize = 64 * 1024;
+
+        JSONReader() = default;
+
+        JSONReader(const JSONReader&) = delete;
+        JSONReader& operator=(const JSONReader&) = delete;
+
+        /**
+         * @brief Read from a memory-mapped file
+         * @param filename The path to the JSON file
+         * @return True if the file could be mapped
+         */
+        bool open(const std::string& filename);
+
+        /**
+         * @brief Read from a buffer owned by the caller
+         * @param content The JSON content, which must outlive the reader
+         */
+        void open_buffer(std::string_view content);
+
+        /**
+         * @brief Read from an input stream in chunks
+         * @param stream The input stream, which must outlive the reader
+         * @param chunk_size Number of bytes read at a time
+         */
+        void open_stream(std::istream& stream, size_t chunk_size = kDefaultChunkSize);
+
+        /**
+         * @brief Read from a callback in chunks
+         * @param read The read callback
+         * @param chunk_size Number of bytes requested at a time
+         */
+        void open_source(ReadFunction read, size_t chunk_size = kDefaultChunkSize);
+
+        /**
+         * @brief Advance to the next event
+         *
+         * After the top-level value the reader reports EndDocument; after
+         * a failure it keeps reporting Error.
+         *
+         * @return The new current event
+         */
+        Event next();
+
+        /**
+         * @brief Get the current event
+         * @return The event returned by the last call to next()
+         */
+        Event event() const { return event_; }
+
+        /**
+         * @brief Get the value of the current token
+         * @return The decoded key or string, the number as written, or "true"/"false"
+         */
+        std::string_view value() const { return value_; }
+
+        /**
+         * @brief Get the value of a Boolean event
+         * @return True for the literal true
+         */
+        bool bool_value() const { return value_ == "true"; }
+
+        /**
+         * @brief Get the nesting depth of the current event
+         * @return Number of enclosing objects and arrays, counting one just started or ended
+         */
+        size_t depth() const { return depth_; }
+
+        /**
+         * @brief Get the byte offset of the current event in the input
+         * @return Offset of the first byte of the current token
+         */
+        size_t offset() const { return token_offset_; }
+
+        /**
+         * @brief Stop with an error at the current token
+         *
+         * For callers that find the input valid JSON but not of the
+         * structure they expect.
+         *
+         * @param message The error description
+         * @return Event::Error
+         */
+        Event report_error(const std::string& message);
+
+        /**
+         * @brief Get the error description after an Error event
+         * @return The error message
+         */
+        const std::string& error_message() const { return error_message_; }
+
+        /**
+         * @brief Get the error position after an Error event
+         * @return Line, column and byte offset of the error
+         */
+        const ErrorLocation& error_location() const { return error_location_; }
+
+    private:
+        // What the grammar allows at the current position
+        enum class Expect {
+            Value,
+            ValueOrEnd,   // First item of an array
+            Key,
+            KeyOrEnd,     // First member of an object
+            Colon,
+            CommaOrEnd,
+            Done          // After the top-level value
+        };
+
+        void reset();
+        Event fail(const std::string& message, size_t at);
+
+        /**
+         * @brief Read the next chunk into the window
+         * @return False at end of input
+         */
+        bool fill();
+
+        /**
+         * @brief Make sure the window holds count bytes from the token start
+         * @return False if the input ends first
+         */
+        bool ensure(size_t count);
+
+        /**
+         * @brief Skip whitespace, reading more input as needed
+         * @return False at end of input
+         */
+        bool skip_whitespace();
+
+        Event read_value();
+        Event read_string(Event event);
+        Event read_number();
+        Event read_literal(std::string_view literal, Event event);
+        Event close_container(char bracket);
+        void value_done();
+
+        std::string_view window() const { return std::string_view(data_ + pos_, size_ - pos_); }
+
+        // Input window; pos_ is the start of the current token
+        const char* data_ = nullptr;
+        size_t size_ = 0;
+        size_t pos_ = 0;
+        size_t base_ = 0; // Absolute offset of data_[0]
+
+        // Chunked input
+        MappedFile file_;
+        ReadFunction read_;
+        std::string buffer_;
+        size_t chunk_size_ = kDefaultChunkSize;
+        bool eof_ = true;
+
+        // Line tracking for error locations over discarded input
+        size_t discarded_lines_ = 0;
+        size_t discarded_line_start_ = 0;
+
+        // Current event
+        Event event_ = Event::EndDocument;
+        std::string_view value_;
+        std::string decoded_; // Backs value_ for strings with escapes
+        size_t depth_ = 0;
+        size_t token_offset_ = 0;
+
+        // Open containers, '{' or '[', and the grammar state
+        std::vector<char> open_;
+        Expect expect_ = Expect::Value;
+
+        std::string error_message_;
+        ErrorLocation error_location_;
+    };
+
+} // namespace parser
@@ -0,0 +1,198 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <ostream>
+
+namespace parser {
+
+    /**
+     * @brief Streaming JSON writer
+     *
+     * Output is appended to one buffer as it is produced. When writing
+     * to a file, a file descriptor or an output stream the buffer is
+     * drained every kFlushSize bytes, and memory use does not grow with
+     * the document. Without an open call the writer fills an internal
+     * buffer read with str(). Output is compact, without whitespace.
+     *
+     * Commas and colons are inserted as needed; the caller only opens
+     * and closes containers, writes keys and writes values.
+     *
+     * A value can be written deferred: once complete it is either kept
+     * as is with release() or made the first item of an array with
+     * wrap_in_array(). This lets a stream of repeated keys be written as
+     * one array without knowing in advance how many will follow. Output
+     * from the oldest unresolved deferred value onwards is held in
+     * memory, up to the defer limit; past it the value is written out
+     * as is and can no longer be wrapped.
+     */
+    class JSONWriter {
+    public:
+        static constexpr size_t kFlushSize = 64 * 1024;
+        static constexpr size_t kDefaultDeferLimit = 16 * 1024 * 1024;
+
+        JSONWriter() = default;
+        ~JSONWriter();
+
+        JSONWriter(const JSONWriter&) = delete;
+        JSONWriter& operator=(const JSONWriter&) = delete;
+
+        /**
+         * @brief Write to a file, replacing its contents
+         * @param filename The output file path
+         * @return True if the file could be created
+         */
+        bool open(const std::string& filename);
+
+        /**
+         * @brief Append to a string owned by the caller
+         * @param out The output string, which must outlive the writer
+         */
+        void open_buffer(std::string& out);
+
+        /**
+         * @brief Write to an output stream
+         * @param stream The output stream, which must outlive the writer
+         */
+        void open_stream(std::ostream& stream);
+
+        /**
+         * @brief Write to a file descriptor owned by the caller
+         * @param fd The file descriptor
+         */
+        void open_fd(int fd);
+
+        /**
+         * @brief Set how much deferred output a file, descriptor or stream writer holds
+         * @param bytes Held bytes after which the oldest deferred value is written out
+         */
+        void set_defer_limit(size_t bytes) { defer_limit_ = bytes; }
+
+        void start_object();
+        void end_object();
+        void start_array();
+        void end_array();
+
+        /**
+         * @brief Write an object member name
+         * @param name The name, escaped on output
+         */
+        void key(std::string_view name);
+
+        /**
+         * @brief Write a string value
+         * @param value The string, escaped on output
+         */
+        void string(std::string_view value);
+
+        /**
+         * @brief Write a number
+         * @param text The number as JSON text, written as is
+         */
+        void number(std::string_view text);
+
+        void boolean(bool value);
+        void null();
+
+        /**
+         * @brief Mark the next value as deferred
+         *
+         * Must be followed by exactly one value, then by release() or
+         * wrap_in_array() before anything else is written at this level.
+         */
+        void defer();
+
+        /**
+         * @brief Keep the most recent deferred value as it was written
+         */
+        void release();
+
+        /**
+         * @brief Make the most recent deferred value the first item of an array
+         *
+         * The array stays open: further values are appended to it, and
+         * end_array() closes it.
+         *
+         * @return False if the value was already written out past the
+         *         defer limit; it is then resolved as kept
+         */
+        bool wrap_in_array();
+
+        /**
+         * @brief Hand buffered output to the file, descriptor or stream
+         * @return False if writing failed
+         */
+        bool flush();
+
+        /**
+         * @brief Flush and close a file opened with open()
+         * @return False if writing failed
+         */
+        bool close();
+
+        /**
+         * @brief Check that no write or usage error occurred
+         * @return True if all output so far was written
+         */
+        bool good() const { return error_.empty(); }
+
+        /**
+         * @brief Get the first error
+         * @return The error message, empty if there was none
+         */
+        const std::string& error_message() const { return error_; }
+
+        /**
+         * @brief Get the number of open objects and arrays
+         * @return Nesting depth
+         */
+        size_t depth() const { return open_.size(); }
+
+        /**
+         * @brief Get the internal buffer
+         * @return Output written so far when no sink was opened
+         */
+        const std::string& str() const { return buffer_; }
+
+    private:
+        struct OpenContainer {
+            bool is_object;
+            bool has_items;   // A member or item was written
+            bool expects_value; // A key was written, its value is next
+        };
+
+        enum class Sink { Buffer, Stream, File };
+
+        void reset();
+        void fail(const char* message);
+        void begin_value();
+        void end_container(bool is_object);
+
+        /**
+         * @brief Get the start of the output that must stay in the buffer
+         * @return Position of the oldest deferred value not yet written out, or the buffer size
+         */
+        size_t held_from() const;
+        void maybe_flush();
+
+        Sink sink_ = Sink::Buffer;
+        std::string buffer_;
+        std::string* out_ = &buffer_;
+        std::ostream* stream_ = nullptr;
+        int fd_ = -1;
+        bool owns_fd_ = false;
+
+        bool written_ = false; // The top-level value was started
+        std::string error_;
+        std::vector<OpenContainer> open_;
+
+        // Output positions of unresolved deferred values, oldest first;
+        // npos once written out. Output from the first position onwards
+        // stays in the buffer.
+        std::vector<size_t> deferred_;
+        bool defer_next_ = false;
+        size_t defer_limit_ = kDefaultDeferLimit;
+    };
+
+} // namespace parser
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+
+namespace parser {
+
+    /**
+     * @brief Read-only memory mapping of a file
+     *
+     * Uses mmap on POSIX systems and MapViewOfFile on Windows. The mapping
+     * is released when the object is destroyed or closed.
+     */
+    class MappedFile {
+    public:
+        MappedFile() = default;
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+
+        /**
+         * @brief Map a file into memory
+         * @param filename The path to the file
+         * @return True if successful
+         */
+        bool open(const std::string& filename);
+
+        /**
+         * @brief Release the mapping
+         */
+        void close();
+
+        /**
+         * @brief Check if a file is mapped
+         * @return True if a file is mapped
+         */
+        bool is_open() const { return open_; }
+
+        /**
+         * @brief Get pointer to the mapped bytes
+         * @return Pointer to the first byte, or nullptr for an empty file
+         */
+        const char* data() const { return data_; }
+
+        /**
+         * @brief Get size of the mapping
+         * @return Size in bytes
+         */
+        size_t size() const { return size_; }
+
+    private:
+        const char* data_ = nullptr;
+        size_t size_ = 0;
+        bool open_ = false;
+#ifdef _WIN32
+        void* file_handle_ = nullptr;
+        void* mapping_handle_ = nullptr;
+#endif
+    };
+
+} // namespace parser
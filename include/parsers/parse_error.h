@@ -0,0 +1,48 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+
+namespace parser {
+
+    /**
+     * @brief Position of a parse error in the input
+     *
+     * Parsers record only the byte offset while parsing; line and column
+     * are derived from it once an error has actually occurred.
+     * Line and column are 1-based, 0 means unknown.
+     */
+    struct ErrorLocation {
+        size_t offset = 0;
+        size_t line = 0;
+        size_t column = 0;
+
+        /**
+         * @brief Compute an error location from a byte offset
+         * @param content The parsed input
+         * @param offset Byte offset of the error
+         * @return Location with line and column filled in
+         */
+        static ErrorLocation from_offset(const std::string& content, size_t offset);
+
+        /**
+         * @brief Format the location for an error message
+         * @return Text such as "line 3, column 7"
+         */
+        std::string to_string() const;
+    };
+
+    /**
+     * @brief Outcome of an internal parsing step
+     *
+     * Parsing functions return it up the call chain instead of keeping
+     * the error on the parser, so a parser holds no state between calls.
+     */
+    struct ParseStatus {
+        std::string message; // Error description, empty on success
+
+        bool ok() const { return message.empty(); }
+        explicit operator bool() const { return ok(); }
+    };
+
+} // namespace parser
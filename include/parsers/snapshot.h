@@ -0,0 +1,219 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include "parsers/json_parser.h"
+#include "parsers/xml_parser.h"
+#include "parsers/mapped_file.h"
+
+namespace parser {
+
+    namespace detail {
+        struct SnapshotHeader;
+        struct SnapshotJSONNode;
+        struct SnapshotXMLNode;
+        struct SnapshotXMLAttribute;
+    }
+
+    /**
+     * @brief Read-only view of a value inside a JSON snapshot
+     *
+     * Mirrors the read API of JSONValue but reads directly from the
+     * snapshot image. Views stay valid as long as the owning snapshot.
+     */
+    class JSONSnapshotValue {
+    public:
+        JSONSnapshotValue() = default;
+
+        JSONValue::Type get_type() const;
+
+        std::string as_string() const;
+        int as_int() const;
+        double as_double() const;
+        bool as_bool() const;
+
+        /**
+         * @brief Get string value without copying
+         * @return View into the snapshot, or empty for non-string values
+         */
+        std::string_view as_string_view() const;
+
+        // Object methods
+        JSONSnapshotValue get(std::string_view key) const;
+        bool has_key(std::string_view key) const;
+        std::vector<std::string> get_keys() const;
+
+        // Array methods
+        JSONSnapshotValue at(size_t index) const;
+        size_t size() const;
+        bool is_array() const { return get_type() == JSONValue::Type::Array; }
+        bool is_object() const { return get_type() == JSONValue::Type::Object; }
+
+        /**
+         * @brief Copy this value and everything below it into a JSONValue
+         * @return Deserialized value
+         */
+        JSONValue to_value() const;
+
+    private:
+        friend class JSONSnapshot;
+
+        JSONSnapshotValue(const char* image, const detail::SnapshotJSONNode* node) : image_(image), node_(node) {}
+
+        std::string_view key() const;
+        JSONSnapshotValue child(uint64_t index) const;
+
+        const char* image_ = nullptr;
+        const detail::SnapshotJSONNode* node_ = nullptr;
+    };
+
+    /**
+     * @brief Memory-mappable binary image of a parsed JSON document
+     *
+     * The image stores every value in one flat, offset-based node table
+     * with object members sorted by key, so lookups run in place without
+     * deserializing the document.
+     */
+    class JSONSnapshot {
+    public:
+        bool success = false;
+        std::string error_message;
+
+        /**
+         * @brief Write a snapshot image of a parsed document
+         * @param result The parsed JSON result
+         * @param filename The output file path
+         * @return True if successful
+         */
+        static bool save(const JSONResult& result, const std::string& filename);
+
+        /**
+         * @brief Build a snapshot image in memory
+         * @param result The parsed JSON result
+         * @return Snapshot image bytes
+         */
+        static std::string to_bytes(const JSONResult& result);
+
+        /**
+         * @brief Memory-map a snapshot file
+         * @param filename The path to the snapshot file
+         * @return JSONSnapshot ready for queries or error information
+         */
+        static JSONSnapshot open(const std::string& filename);
+
+        /**
+         * @brief Load a snapshot image from memory
+         * @param data Snapshot image bytes
+         * @return JSONSnapshot ready for queries or error information
+         */
+        static JSONSnapshot from_bytes(const std::string& data);
+
+        /**
+         * @brief Get the root value
+         * @return View of the root value
+         */
+        JSONSnapshotValue root() const;
+
+        std::string get_string(const std::string& path, const std::string& default_value = "") const;
+        int get_int(const std::string& path, int default_value = 0) const;
+        double get_double(const std::string& path, double default_value = 0.0) const;
+        bool get_bool(const std::string& path, bool default_value = false) const;
+
+        /**
+         * @brief Get a value by path (e.g., "address.city")
+         * @param path The path to the value
+         * @return View of the value, Null if not found
+         */
+        JSONSnapshotValue get_value(const std::string& path) const;
+
+        bool has_path(const std::string& path) const;
+        std::vector<std::string> get_keys(const std::string& path = "") const;
+
+    private:
+        bool attach(const char* data, size_t size);
+
+        MappedFile file_;
+        std::vector<uint64_t> buffer_;
+        const char* image_ = nullptr;
+    };
+
+    /**
+     * @brief Read-only view of an element inside an XML snapshot
+     *
+     * Mirrors the read API of XMLNode. A default constructed view is
+     * invalid and converts to false.
+     */
+    class XMLSnapshotNode {
+    public:
+        XMLSnapshotNode() = default;
+
+        explicit operator bool() const { return node_ != nullptr; }
+
+        std::string_view name() const;
+        std::string_view value() const;
+
+        XMLSnapshotNode get_child(std::string_view child_name) const;
+        std::vector<XMLSnapshotNode> get_children(std::string_view child_name) const;
+        size_t child_count() const;
+        XMLSnapshotNode child(size_t index) const;
+
+        std::string get_attribute(std::string_view attr_name, const std::string& default_value = "") const;
+        bool has_attribute(std::string_view attr_name) const;
+        size_t attribute_count() const;
+        std::string_view attribute_name(size_t index) const;
+        std::string_view attribute_value(size_t index) const;
+
+    private:
+        friend class XMLSnapshot;
+
+        XMLSnapshotNode(const char* image, const detail::SnapshotXMLNode* node) : image_(image), node_(node) {}
+
+        const detail::SnapshotXMLAttribute* find_attribute(std::string_view attr_name) const;
+
+        const char* image_ = nullptr;
+        const detail::SnapshotXMLNode* node_ = nullptr;
+    };
+
+    /**
+     * @brief Memory-mappable binary image of a parsed XML document
+     *
+     * Elements are stored breadth-first so that the children of every
+     * element are contiguous; names and text live in a shared string pool.
+     */
+    class XMLSnapshot {
+    public:
+        bool success = false;
+        std::string error_message;
+
+        static bool save(const XMLResult& result, const std::string& filename);
+        static std::string to_bytes(const XMLResult& result);
+        static XMLSnapshot open(const std::string& filename);
+        static XMLSnapshot from_bytes(const std::string& data);
+
+        XMLSnapshotNode root() const;
+
+        std::string get_value(const std::string& path, const std::string& default_value = "") const;
+        std::string get_attribute(const std::string& path, const std::string& attr_name, const std::string& default_value = "") const;
+
+        /**
+         * @brief Get node by path (e.g., "config.database.host")
+         * @param path The path to the node
+         * @return View of the node, invalid if not found
+         */
+        XMLSnapshotNode get_node(const std::string& path) const;
+
+        bool has_path(const std::string& path) const;
+        std::vector<std::string> get_children(const std::string& path = "") const;
+        std::vector<std::string> get_attributes(const std::string& path) const;
+
+    private:
+        bool attach(const char* data, size_t size);
+
+        MappedFile file_;
+        std::vector<uint64_t> buffer_;
+        const char* image_ = nullptr;
+    };
+
+} // namespace parser
@@ -0,0 +1,307 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include "parsers/xml_parser.h"
+#include "parsers/xml_reader.h"
+#include "parsers/xml_name_table.h"
+
+namespace parser {
+
+    class XMLDocument;
+
+    /**
+     * @brief Lightweight handle to an element of an XMLDocument
+     *
+     * A handle is a document pointer plus a node index. Indices never
+     * change once a node is created, so handles stay valid while the
+     * document is alive and not moved. A default constructed handle is
+     * invalid and converts to false.
+     */
+    class XMLNodeRef {
+    public:
+        XMLNodeRef() = default;
+
+        explicit operator bool() const { return doc_ != nullptr; }
+        bool operator==(const XMLNodeRef& other) const { return doc_ == other.doc_ && index_ == other.index_; }
+        bool operator!=(const XMLNodeRef& other) const { return !(*this == other); }
+
+        /**
+         * @brief Get the index of this node in the document
+         * @return Node index
+         */
+        uint32_t index() const { return index_; }
+
+        std::string_view name() const;
+        std::string_view value() const;
+
+        /**
+         * @brief Get the interned ID of the element name
+         * @return Name ID in the document's name table
+         */
+        uint32_t name_id() const;
+
+        /**
+         * @brief Get the namespace URI of the element
+         * @return The URI, empty if there is none or namespaces were not resolved
+         */
+        std::string_view namespace_uri() const;
+
+        /**
+         * @brief Get the interned ID of the namespace URI
+         * @return URI ID in the document's name table, or XMLNameTable::npos
+         */
+        uint32_t namespace_id() const;
+
+        std::string_view local_name() const;
+
+        // Tree navigation
+        XMLNodeRef parent() const;
+        XMLNodeRef first_child() const;
+        XMLNodeRef next_sibling() const;
+        size_t child_count() const;
+
+        /**
+         * @brief Get child node by name
+         * @param child_name The name of the child node
+         * @return Handle to the first matching child, invalid if not found
+         */
+        XMLNodeRef get_child(std::string_view child_name) const;
+
+        /**
+         * @brief Get all child nodes with specific name
+         * @param child_name The name of child nodes to find
+         * @return Vector of child handles
+         */
+        std::vector<XMLNodeRef> get_children(std::string_view child_name) const;
+
+        /**
+         * @brief Get child node by namespace URI and local name
+         * @param namespace_uri The namespace URI, empty for no namespace
+         * @param local_name The name without prefix
+         * @return Handle to the first matching child, invalid if not found
+         */
+        XMLNodeRef get_child_ns(std::string_view namespace_uri, std::string_view local_name) const;
+
+        /**
+         * @brief Get attribute value
+         * @param attr_name The attribute name
+         * @param default_value Default value if attribute not found
+         * @return The attribute value
+         */
+        std::string get_attribute(std::string_view attr_name, const std::string& default_value = "") const;
+
+        /**
+         * @brief Check if node has attribute
+         * @param attr_name The attribute name
+         * @return True if attribute exists
+         */
+        bool has_attribute(std::string_view attr_name) const;
+
+        /**
+         * @brief Get attribute value by namespace URI and local name
+         * @param namespace_uri The namespace URI, empty for no namespace
+         * @param local_name The name without prefix
+         * @param default_value Default value if attribute not found
+         * @return The attribute value
+         */
+        std::string get_attribute_ns(std::string_view namespace_uri, std::string_view local_name, const std::string& default_value = "") const;
+
+        /**
+         * @brief Get all attribute names in document order
+         * @return Vector of attribute names
+         */
+        std::vector<std::string> get_attribute_names() const;
+
+    private:
+        friend class XMLDocument;
+
+        XMLNodeRef(const XMLDocument* doc, uint32_t index) : doc_(doc), index_(index) {}
+
+        const XMLDocument* doc_ = nullptr;
+        uint32_t index_ = 0;
+    };
+
+    /**
+     * @brief Flat, index-based XML document
+     *
+     * All elements live in one contiguous array linked by parent,
+     * first-child and next-sibling indices. Attributes are kept in a side
+     * table and text in a single string pool. Element and attribute
+     * names and namespace URIs are interned in a per-document name table
+     * and compared by ID. Every table holds trivially copyable records,
+     * so traversal stays cache friendly and copying a document amounts
+     * to copying a handful of buffers.
+     */
+    class XMLDocument {
+    public:
+        static constexpr uint32_t npos = UINT32_MAX;
+
+        bool success = false;
+        std::string error_message;
+        ErrorLocation error_location;
+
+        /**
+         * @brief Parse XML content into a flat document
+         *
+         * Of the options, only resolve_namespaces applies.
+         *
+         * @param content The XML content as string
+         * @param options Parse options
+         * @return XMLDocument with parsed data or error information
+         */
+        static XMLDocument parse(const std::string& content, const XMLParseOptions& options = XMLParseOptions());
+
+        /**
+         * @brief Parse a memory-mapped XML file into a flat document
+         * @param filename The path to the XML file
+         * @param options Parse options, as for parse()
+         * @return XMLDocument with parsed data or error information
+         */
+        static XMLDocument parse_file(const std::string& filename, const XMLParseOptions& options = XMLParseOptions());
+
+        /**
+         * @brief Build a document from the element at the reader position
+         *
+         * The reader must be on a StartElement. It is advanced to the
+         * matching EndElement, so single records can be materialized
+         * while streaming through a large input. Namespaces are kept if
+         * the reader is namespace aware.
+         *
+         * @param reader The reader
+         * @return XMLDocument holding the element and its subtree
+         */
+        static XMLDocument read_element(XMLReader& reader);
+
+        /**
+         * @brief Build a flat document from a node tree
+         * @param root The root node
+         * @return Document holding a copy of the tree
+         */
+        static XMLDocument from_node(const XMLNode& root);
+
+        /**
+         * @brief Convert the document back to a node tree
+         *
+         * Namespace URIs are not carried over; the names keep their prefixes.
+         *
+         * @return Root node of the tree
+         */
+        XMLNode to_node() const;
+
+        /**
+         * @brief Get the root element
+         * @return Handle to the root, invalid if the document is empty
+         */
+        XMLNodeRef root() const;
+
+        /**
+         * @brief Get a node by index
+         * @param index The node index
+         * @return Handle to the node, invalid if out of range
+         */
+        XMLNodeRef node(uint32_t index) const;
+
+        /**
+         * @brief Get number of elements in the document
+         * @return Element count
+         */
+        size_t size() const { return nodes_.size(); }
+
+        /**
+         * @brief Get the table of element and attribute names
+         * @return The name table
+         */
+        const XMLNameTable& names() const { return names_; }
+
+        // Path access, same semantics as XMLResult
+        std::string get_value(const std::string& path, const std::string& default_value = "") const;
+        std::string get_attribute(const std::string& path, const std::string& attr_name, const std::string& default_value = "") const;
+        XMLNodeRef get_node(const std::string& path) const;
+        bool has_path(const std::string& path) const;
+        std::vector<std::string> get_children(const std::string& path = "") const;
+        std::vector<std::string> get_attributes(const std::string& path) const;
+
+        /**
+         * @brief Append an element
+         * @param parent Index of the parent, or npos to create the root
+         * @param name The element name
+         * @return Index of the new element, or npos if the root already exists
+         */
+        uint32_t append_child(uint32_t parent, std::string_view name);
+
+        /**
+         * @brief Set the text value of an element
+         * @param node The element index
+         * @param value The text value
+         */
+        void set_value(uint32_t node, std::string_view value);
+
+        /**
+         * @brief Set an attribute, replacing an existing value
+         * @param node The element index
+         * @param name The attribute name
+         * @param value The attribute value
+         */
+        void set_attribute(uint32_t node, std::string_view name, std::string_view value);
+
+        /**
+         * @brief Set the namespace URI of an element
+         * @param node The element index
+         * @param uri The namespace URI, empty for no namespace
+         */
+        void set_namespace_uri(uint32_t node, std::string_view uri);
+
+        /**
+         * @brief Set the namespace URI of an existing attribute
+         * @param node The element index
+         * @param name The attribute name
+         * @param uri The namespace URI, empty for no namespace
+         */
+        void set_attribute_namespace_uri(uint32_t node, std::string_view name, std::string_view uri);
+
+    private:
+        friend class XMLNodeRef;
+
+        struct Span {
+            size_t offset = 0;
+            size_t length = 0;
+        };
+
+        struct NodeData {
+            uint32_t name = npos;
+            uint32_t namespace_uri = npos;
+            Span value;
+            uint32_t parent = npos;
+            uint32_t first_child = npos;
+            uint32_t last_child = npos;
+            uint32_t next_sibling = npos;
+            uint32_t first_attribute = npos;
+            uint32_t last_attribute = npos;
+        };
+
+        struct AttributeData {
+            uint32_t name = npos;
+            uint32_t namespace_uri = npos;
+            Span value;
+            uint32_t next = npos;
+        };
+
+        static XMLDocument parse_root(XMLReader& reader);
+
+        uint32_t intern_uri(std::string_view uri) { return uri.empty() ? npos : names_.intern(uri); }
+
+        Span store(std::string_view text);
+        std::string_view view(const Span& span) const;
+        const AttributeData* find_attribute(uint32_t node, std::string_view name) const;
+        XMLNodeRef find_child(uint32_t node, uint32_t name) const;
+
+        XMLNameTable names_;
+        std::vector<NodeData> nodes_;
+        std::vector<AttributeData> attributes_;
+        std::string strings_;
+    };
+
+} // namespace parser
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include "parsers/parse_error.h"
+#include "parsers/json_reader.h"
+#include "parsers/json_writer.h"
+#include "parsers/xml_reader.h"
+#include "parsers/xml_writer.h"
+
+namespace parser {
+
+    /**
+     * @brief Options for XMLJSONConverter
+     */
+    struct XMLJSONOptions {
+        // Prefix of the members holding attributes
+        std::string attribute_prefix = "@";
+
+        // Member holding the text of an element that also has attributes
+        // or child elements
+        std::string text_key = "#text";
+
+        // Write adjacent child elements of the same name as one array;
+        // otherwise each is written as its own, repeated, member
+        bool group_repeated = true;
+
+        // Element names always written as an array, even when they occur
+        // once. Their elements are never held back to detect repetition.
+        std::vector<std::string> array_elements;
+
+        // Strip leading and trailing whitespace from text and drop text
+        // that is only whitespace
+        bool trim_text = true;
+    };
+
+    /**
+     * @brief Result of a conversion
+     */
+    struct XMLJSONResult {
+        bool success = false;
+        std::string error_message;
+        ErrorLocation error_location; // Position in the input, if the input was at fault
+    };
+
+    /**
+     * @brief Streaming converter between XML and JSON
+     *
+     * Reads one format with a pull reader and writes the other with a
+     * streaming writer, so no tree is built for either side. An element
+     * becomes a member named after it:
+     *
+     *   <item id="7">text</item>           "item": {"@id": "7", "#text": "text"}
+     *   <item>text</item>                  "item": "text"
+     *   <item/>                            "item": null
+     *   <list><a>1</a><a>2</a></list>      "list": {"a": ["1", "2"]}
+     *
+     * The JSON document is one object whose single member is the root
+     * element. Comments and processing instructions are dropped, and XML
+     * text is always written as a JSON string.
+     *
+     * Repeated elements are grouped into an array when they are adjacent
+     * siblings. Until the next sibling shows whether the first one
+     * repeats, its output is held by the JSON writer, up to the writer's
+     * defer limit. An element repeating after a first instance larger
+     * than that fails the conversion; list such names in array_elements.
+     *
+     * From JSON, numbers and booleans become text as written, null an
+     * empty element and arrays repeated elements. Attribute members must
+     * precede all other members of their object.
+     */
+    class XMLJSONConverter {
+    public:
+        XMLJSONConverter() = default;
+        explicit XMLJSONConverter(const XMLJSONOptions& options) : options_(options) {}
+
+        /**
+         * @brief Convert the XML read from a reader to JSON
+         * @param reader The XML input, opened and not yet read
+         * @param writer The JSON output
+         * @return XMLJSONResult with error information
+         */
+        XMLJSONResult xml_to_json(XMLReader& reader, JSONWriter& writer) const;
+
+        /**
+         * @brief Convert the JSON read from a reader to XML
+         * @param reader The JSON input, opened and not yet read
+         * @param writer The XML output
+         * @return XMLJSONResult with error information
+         */
+        XMLJSONResult json_to_xml(JSONReader& reader, XMLWriter& writer) const;
+
+        /**
+         * @brief Convert XML content to a JSON string
+         * @param xml The XML content
+         * @param json Receives the JSON text
+         * @return XMLJSONResult with error information
+         */
+        XMLJSONResult xml_to_json(std::string_view xml, std::string& json) const;
+
+        /**
+         * @brief Convert JSON content to an XML string
+         * @param json The JSON content
+         * @param xml Receives the XML text
+         * @return XMLJSONResult with error information
+         */
+        XMLJSONResult json_to_xml(std::string_view json, std::string& xml) const;
+
+        /**
+         * @brief Convert an XML file to a JSON file
+         * @param xml_filename The path to the XML file
+         * @param json_filename The path of the JSON file to write
+         * @return XMLJSONResult with error information
+         */
+        XMLJSONResult xml_file_to_json(const std::string& xml_filename, const std::string& json_filename) const;
+
+        /**
+         * @brief Convert a JSON file to an XML file with an XML declaration
+         * @param json_filename The path to the JSON file
+         * @param xml_filename The path of the XML file to write
+         * @return XMLJSONResult with error information
+         */
+        XMLJSONResult json_file_to_xml(const std::string& json_filename, const std::string& xml_filename) const;
+
+    private:
+        bool is_array_element(std::string_view name) const;
+
+        XMLJSONOptions options_;
+    };
+
+} // namespace parser
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+
+namespace parser {
+
+    /**
+     * @brief Resource limits for parsing untrusted XML
+     *
+     * A limit of 0 means unlimited. Each limit is checked as the input is
+     * read, and exceeding one fails the parse with a "Maximum ...
+     * exceeded" error at the offending position.
+     */
+    struct XMLLimits {
+        // Nesting depth of elements; the root element is at depth 1
+        size_t max_depth = 0;
+
+        // Attributes on one element
+        size_t max_attributes = 0;
+
+        // Length of one element or attribute name
+        size_t max_name_length = 0;
+
+        // Text of one element or one attribute value, in bytes
+        size_t max_text_size = 0;
+
+        // Elements in the document
+        size_t max_elements = 0;
+
+        // Size of the input in bytes
+        size_t max_document_size = 0;
+    };
+
+} // namespace parser
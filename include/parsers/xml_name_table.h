@@ -0,0 +1,69 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+namespace parser {
+
+    /**
+     * @brief Table of interned XML names
+     *
+     * Every distinct name is stored once and identified by a dense
+     * 32-bit ID, so names can be compared by ID instead of by content.
+     * Names live in one string pool and are found through an
+     * open-addressing hash table of IDs. The table holds no pointers
+     * into itself, so it copies and moves like a plain value.
+     */
+    class XMLNameTable {
+    public:
+        static constexpr uint32_t npos = UINT32_MAX;
+
+        /**
+         * @brief Get the ID of a name, adding it if it is new
+         * @param name The name
+         * @return The name ID
+         */
+        uint32_t intern(std::string_view name);
+
+        /**
+         * @brief Get the ID of a name without adding it
+         * @param name The name
+         * @return The name ID, or npos if the name is not in the table
+         */
+        uint32_t find(std::string_view name) const;
+
+        /**
+         * @brief Get the name for an ID
+         * @param id The name ID
+         * @return The name, empty for an unknown ID
+         */
+        std::string_view name(uint32_t id) const;
+
+        /**
+         * @brief Get number of names in the table
+         * @return Name count
+         */
+        size_t size() const { return entries_.size(); }
+
+    private:
+        struct Entry {
+            size_t offset;
+            size_t length;
+            size_t hash;
+        };
+
+        /**
+         * @brief Find the slot holding a name, or the empty slot it would go to
+         * @return Slot index
+         */
+        size_t probe(std::string_view name, size_t hash) const;
+        void grow();
+
+        std::string pool_;
+        std::vector<Entry> entries_;
+        std::vector<uint32_t> slots_; // Name IDs, npos for empty slots
+    };
+
+} // namespace parser
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include "parsers/xml_name_table.h"
+
+namespace parser {
+
+    /**
+     * @brief Namespace prefix bindings of the currently open elements
+     *
+     * Declarations are kept on a stack with one scope per open element,
+     * so leaving an element drops its declarations at once. A prefix is
+     * resolved by comparing it with the few bindings in scope, without
+     * hashing. URIs are interned: each distinct URI is stored once and
+     * namespaces compare by ID. IDs stay valid across clear().
+     */
+    class XMLNamespaceScope {
+    public:
+        // URI ID meaning "no namespace"
+        static constexpr uint32_t npos = XMLNameTable::npos;
+
+        static constexpr const char* kXMLNamespace = "http://www.w3.org/XML/1998/namespace";
+        static constexpr const char* kXMLNSNamespace = "http://www.w3.org/2000/xmlns/";
+
+        XMLNamespaceScope();
+
+        /**
+         * @brief Drop all scopes, keeping only the predefined xml and xmlns prefixes
+         */
+        void clear();
+
+        /**
+         * @brief Open the scope of an element
+         */
+        void push();
+
+        /**
+         * @brief Close the innermost scope and drop its declarations
+         */
+        void pop();
+
+        /**
+         * @brief Declare a prefix in the innermost scope
+         * @param prefix The prefix, empty for the default namespace
+         * @param uri The namespace URI; empty undeclares the default namespace
+         * @return nullptr if successful, otherwise an error message
+         */
+        const char* bind(std::string_view prefix, std::string_view uri);
+
+        /**
+         * @brief Find the namespace of a prefix
+         * @param prefix The prefix, empty for the default namespace
+         * @param uri Receives the URI ID, or npos for no namespace
+         * @return False if a non-empty prefix is not declared
+         */
+        bool resolve(std::string_view prefix, uint32_t& uri) const;
+
+        /**
+         * @brief Get the URI for an ID
+         * @param id The URI ID
+         * @return The URI, empty for npos
+         */
+        std::string_view uri(uint32_t id) const;
+
+        /**
+         * @brief Get the number of distinct URIs seen so far
+         * @return URI count; IDs are below this value
+         */
+        size_t uri_count() const { return uris_.size(); }
+
+        /**
+         * @brief Get the prefix of a qualified name
+         * @param qname The name, e.g. "soap:Envelope"
+         * @return The prefix, empty if there is none
+         */
+        static std::string_view prefix(std::string_view qname);
+
+        /**
+         * @brief Get the local part of a qualified name
+         * @param qname The name, e.g. "soap:Envelope"
+         * @return The name after the prefix
+         */
+        static std::string_view local_name(std::string_view qname);
+
+        /**
+         * @brief Check for a namespace declaration attribute
+         * @param attr_name The attribute name
+         * @param prefix Receives the declared prefix, empty for xmlns="..."
+         * @return True for xmlns and xmlns:prefix
+         */
+        static bool is_declaration(std::string_view attr_name, std::string_view& prefix);
+
+    private:
+        struct Binding {
+            std::string prefix;
+            uint32_t uri;
+        };
+
+        XMLNameTable uris_;
+        std::vector<Binding> bindings_;
+        std::vector<size_t> scopes_; // Size of bindings_ when each scope opened
+    };
+
+} // namespace parser
@@ -1,34 +1,232 @@
 #pragma once
 
 #include <string>
-#include <map>
 #include <vector>
+#include <string_view>
+#include <memory>
+#include <memory_resource>
+#include <cstdint>
+#include <functional>
+#include <shared_mutex>
+#include <unordered_map>
+#include "parsers/parse_error.h"
+#include "parsers/xml_limits.h"
+#include "parsers/xml_reader.h"
+#include "parsers/xml_namespaces.h"
 
 namespace parser {
 
+    /**
+     * @brief Memory resource of nodes and attributes created without one
+     *
+     * Allocates with plain operator new and delete, and only uses the
+     * aligned overloads for over-aligned requests, which
+     * std::pmr::new_delete_resource() may use for every request.
+     * @return The resource, shared by all threads
+     */
+    std::pmr::memory_resource* xml_heap_resource();
+
+    /**
+     * @brief Name and value of an XML attribute
+     */
+    struct XMLAttribute {
+        using allocator_type = std::pmr::polymorphic_allocator<char>;
+
+        std::pmr::string name;
+        std::pmr::string value;
+
+        XMLAttribute() : XMLAttribute(allocator_type(xml_heap_resource())) {}
+        explicit XMLAttribute(const allocator_type& alloc) : name(alloc), value(alloc) {}
+        XMLAttribute(std::string_view attr_name, std::string_view attr_value, const allocator_type& alloc = allocator_type(xml_heap_resource()))
+            : name(attr_name, alloc), value(attr_value, alloc) {}
+        XMLAttribute(const XMLAttribute& other);
+        XMLAttribute(XMLAttribute&& other) noexcept = default;
+        XMLAttribute(const XMLAttribute& other, const allocator_type& alloc);
+        // Inline, since vectors of attributes relocate through it when they grow
+        XMLAttribute(XMLAttribute&& other, const allocator_type& alloc)
+            : name(std::move(other.name), alloc),
+              value(std::move(other.value), alloc),
+              namespace_(std::move(other.namespace_)),
+              sorted_(other.sorted_) {
+            if (namespace_ && other.name.get_allocator() != alloc) {
+                rehome_namespace();
+            }
+        }
+        XMLAttribute& operator=(const XMLAttribute& other);
+        XMLAttribute& operator=(XMLAttribute&& other);
+
+        /**
+         * @brief Get the namespace URI resolved while parsing
+         * @return The URI, empty if there is none or namespaces were not resolved
+         */
+        std::string_view namespace_uri() const { return namespace_ ? std::string_view(*namespace_) : std::string_view(); }
+
+        std::string_view local_name() const { return XMLNamespaceScope::local_name(name); }
+
+    private:
+        friend class XMLParser;
+        friend class XMLAttributes;
+
+        // Copy the namespace URI into this attribute's memory resource
+        void rehome_namespace();
+
+        // Interned URI, shared by all names in the same namespace
+        std::shared_ptr<const std::pmr::string> namespace_;
+
+        // In lists with an index: position of the attribute whose name
+        // sorts at this attribute's position
+        uint32_t sorted_ = 0;
+    };
+
+    /**
+     * @brief Attribute list of an XML element
+     *
+     * Attributes are kept in a flat vector in document order. Lookups
+     * scan the vector for the usual handful of attributes; lists longer
+     * than kIndexThreshold also record the name order in the attributes
+     * themselves and use binary search. The interface follows std::map
+     * where it can.
+     */
+    class XMLAttributes {
+    public:
+        using allocator_type = std::pmr::polymorphic_allocator<char>;
+        using const_iterator = std::pmr::vector<XMLAttribute>::const_iterator;
+
+        static constexpr size_t kIndexThreshold = 8;
+
+        XMLAttributes() : items_(allocator_type(xml_heap_resource())) {}
+        explicit XMLAttributes(const allocator_type& alloc) : items_(alloc) {}
+        XMLAttributes(const XMLAttributes& other) = default;
+        XMLAttributes(XMLAttributes&& other) noexcept = default;
+        XMLAttributes(const XMLAttributes& other, const allocator_type& alloc) : items_(other.items_, alloc) {}
+        XMLAttributes(XMLAttributes&& other, const allocator_type& alloc) : items_(std::move(other.items_), alloc) {}
+        XMLAttributes& operator=(const XMLAttributes& other) = default;
+        XMLAttributes& operator=(XMLAttributes&& other) = default;
+
+        const_iterator begin() const { return items_.begin(); }
+        const_iterator end() const { return items_.end(); }
+        size_t size() const { return items_.size(); }
+        bool empty() const { return items_.empty(); }
+        void reserve(size_t count) { items_.reserve(count); }
+        void clear();
+
+        /**
+         * @brief Find an attribute by name
+         * @param name The attribute name
+         * @return Iterator to the attribute, or end() if not found
+         */
+        const_iterator find(std::string_view name) const;
+
+        /**
+         * @brief Count attributes with a name
+         * @param name The attribute name
+         * @return 1 if the attribute exists, otherwise 0
+         */
+        size_t count(std::string_view name) const { return find(name) != end() ? 1 : 0; }
+
+        /**
+         * @brief Access an attribute value, appending the attribute if missing
+         * @param name The attribute name
+         * @return Reference to the value
+         */
+        std::pmr::string& operator[](std::string_view name);
+
+        /**
+         * @brief Remove an attribute
+         * @param name The attribute name
+         * @return Number of attributes removed
+         */
+        size_t erase(std::string_view name);
+
+    private:
+        friend class XMLParser;
+
+        /**
+         * @brief Binary search of the name order of the first count attributes
+         * @return Place in the name order of the first name not less than name
+         */
+        size_t lower_bound(std::string_view name, size_t count) const;
+
+        void rebuild_index();
+
+        // Lists longer than kIndexThreshold keep the name order in XMLAttribute::sorted_
+        std::pmr::vector<XMLAttribute> items_;
+    };
+
     /**
      * @brief XML node structure
+     *
+     * Copying or moving a node re-links the parent pointers of its
+     * children, so parent pointers stay valid when a node is copied or
+     * when the children vector reallocates.
+     *
+     * A node allocates everything it owns from the memory resource it was
+     * constructed with: strings, attributes, children, the child index
+     * and the strings it shares with other nodes. Children get the same
+     * resource. Nodes created without one, and copies unless one is
+     * passed, use xml_heap_resource(); moving a node to a container with
+     * another resource copies its subtree there.
+     *
+     * get_child() and get_children() scan the children; for repeated
+     * lookups in nodes with many children, build an XMLChildIndex.
+     *
+     * When parsing with XMLParseOptions::preserve_content, text, CDATA,
+     * comments and processing instructions inside elements are kept as
+     * children of their own type, in document order. These content nodes
+     * have no name; their text is a span into a shared copy of the input
+     * and is only copied when read through raw() or text().
      */
     struct XMLNode {
-        std::string name;
-        std::string value;
-        std::map<std::string, std::string> attributes;
-        std::vector<XMLNode> children;
+        enum class Type {
+            Element,
+            Text,
+            CData,
+            Comment,
+            ProcessingInstruction
+        };
+
+        using allocator_type = std::pmr::polymorphic_allocator<char>;
+
+        Type type = Type::Element;
+        std::pmr::string name;
+        std::pmr::string value;
+        XMLAttributes attributes;
+        std::pmr::vector<XMLNode> children;
         XMLNode* parent = nullptr;
+
+        XMLNode() : XMLNode(allocator_type(xml_heap_resource())) {}
+        explicit XMLNode(const allocator_type& alloc);
+        XMLNode(const XMLNode& other);
+        XMLNode(const XMLNode& other, const allocator_type& alloc);
+        XMLNode(XMLNode&& other) noexcept;
+        XMLNode(XMLNode&& other, const allocator_type& alloc);
+
+        /**
+         * Frees the subtree without recursion, so tearing down a deep
+         * document cannot exhaust the call stack.
+         */
+        ~XMLNode();
+
+        /**
+         * Assignment replaces the content of this node but keeps its
+         * position in the tree, i.e. its parent pointer.
+         */
+        XMLNode& operator=(const XMLNode& other);
+        XMLNode& operator=(XMLNode&& other) noexcept;
         
         /**
          * @brief Get child node by name
          * @param child_name The name of the child node
          * @return Pointer to child node or nullptr if not found
          */
-        XMLNode* get_child(const std::string& child_name);
+        XMLNode* get_child(std::string_view child_name);
         
         /**
          * @brief Get child node by name (const version)
          * @param child_name The name of the child node
          * @return Pointer to child node or nullptr if not found
          */
-        const XMLNode* get_child(const std::string& child_name) const;
+        const XMLNode* get_child(std::string_view child_name) const;
         
         /**
          * @brief Get attribute value
@@ -62,8 +260,16 @@ namespace parser {
         /**
          * @brief Add child node
          * @param child The child node to add
+         * @return Reference to the added child
          */
-        void add_child(const XMLNode& child);
+        XMLNode& add_child(const XMLNode& child);
+
+        /**
+         * @brief Add child node without copying its subtree
+         * @param child The child node to move in
+         * @return Reference to the added child
+         */
+        XMLNode& add_child(XMLNode&& child);
         
         /**
          * @brief Set attribute
@@ -71,15 +277,241 @@ namespace parser {
          * @param value The attribute value
          */
         void set_attribute(const std::string& name, const std::string& value);
+
+        /**
+         * @brief Create a text, CDATA, comment or processing instruction node
+         * @param type The content type
+         * @param raw The content as written between its delimiters
+         * @return The content node
+         */
+        static XMLNode make_content(Type type, std::string_view raw);
+
+        bool is_element() const { return type == Type::Element; }
+
+        allocator_type get_allocator() const { return children.get_allocator(); }
+
+        /**
+         * @brief Get the content of a content node as written
+         * @return The raw content, empty for elements
+         */
+        std::string_view raw() const;
+
+        /**
+         * @brief Get the text of a content node
+         * @return Decoded text for Text nodes, the raw content otherwise
+         */
+        std::string text() const;
+
+        /**
+         * @brief Get the namespace URI resolved while parsing
+         * @return The URI, empty if there is none or namespaces were not resolved
+         */
+        std::string_view namespace_uri() const { return namespace_ ? std::string_view(*namespace_) : std::string_view(); }
+
+        /**
+         * @brief Get the element name without its prefix
+         * @return The local name
+         */
+        std::string_view local_name() const { return XMLNamespaceScope::local_name(name); }
+
+        /**
+         * @brief Get child element by namespace URI and local name
+         * @param namespace_uri The namespace URI, empty for no namespace
+         * @param local_name The name without prefix
+         * @return Pointer to child node or nullptr if not found
+         */
+        XMLNode* get_child_ns(std::string_view namespace_uri, std::string_view local_name);
+        const XMLNode* get_child_ns(std::string_view namespace_uri, std::string_view local_name) const;
+
+        /**
+         * @brief Get attribute value by namespace URI and local name
+         * @param namespace_uri The namespace URI, empty for no namespace
+         * @param local_name The name without prefix
+         * @param default_value Default value if attribute not found
+         * @return The attribute value
+         */
+        std::string get_attribute_ns(std::string_view namespace_uri, std::string_view local_name, const std::string& default_value = "") const;
+
+    private:
+        friend class XMLParser;
+
+        /**
+         * @brief Append copies of the children of other, and theirs, to this node
+         */
+        void copy_children(const XMLNode& other);
+
+        /**
+         * @brief Share the namespace and raw content of other, copying
+         * them into this node's resource if other has another one
+         */
+        void copy_shared(const XMLNode& other);
+
+        /**
+         * @brief Point the parent pointer of every child at this node
+         */
+        void relink_children();
+
+        // Interned URI, shared by all names in the same namespace
+        std::shared_ptr<const std::pmr::string> namespace_;
+
+        // Content nodes: span of raw() within source_
+        std::shared_ptr<const std::pmr::string> source_;
+        size_t raw_offset_ = 0;
+        size_t raw_length_ = 0;
+    };
+
+    /**
+     * @brief Precompiled dotted path (e.g., "config.database.host")
+     *
+     * Splits the path once so it can be resolved against any number of
+     * trees without parsing it again. Empty components are ignored.
+     */
+    class XMLPath {
+    public:
+        XMLPath() = default;
+        explicit XMLPath(const std::string& path);
+
+        /**
+         * @brief Find the node the path leads to
+         * @param root The node the path starts from
+         * @return Pointer to the node or nullptr if not found
+         */
+        const XMLNode* resolve(const XMLNode& root) const;
+
+        /**
+         * @brief Find the node a path leads to without compiling it
+         * @param root The node the path starts from
+         * @param path The dotted path
+         * @return Pointer to the node or nullptr if not found
+         */
+        static const XMLNode* resolve(const XMLNode& root, std::string_view path);
+
+        const std::string& str() const { return path_; }
+        const std::vector<std::string>& components() const { return components_; }
+
+    private:
+        std::string path_;
+        std::vector<std::string> components_;
+    };
+
+    /**
+     * @brief Caller-owned name index over the children of one node
+     *
+     * For nodes with many children that are looked up by name many
+     * times: the index sorts the children by name hash once, after which
+     * a lookup is a binary search instead of a scan. Matches come in
+     * document order. Entries point into the node, so the index does not
+     * notice a child being renamed or replaced: build a new one after
+     * editing them. Lookups fall back to a scan once children were added
+     * or removed. Safe for concurrent readers.
+     */
+    class XMLChildIndex {
+    public:
+        explicit XMLChildIndex(const XMLNode& node);
+
+        /**
+         * @brief Get the first child with the given name
+         * @param child_name The name of the child node
+         * @return Pointer to child node or nullptr if not found
+         */
+        const XMLNode* find(std::string_view child_name) const;
+
+        /**
+         * @brief Get all children with the given name
+         * @param child_name The name of child nodes to find
+         * @return Vector of child nodes, in document order
+         */
+        std::vector<const XMLNode*> find_all(std::string_view child_name) const;
+
+    private:
+        /**
+         * @brief Call visit(child) for each child with the given name
+         * @param child_name The name of child nodes to find
+         * @param visit Callback returning false to stop
+         */
+        template <typename Visitor>
+        void visit_named(std::string_view child_name, Visitor&& visit) const;
+
+        const XMLNode* node_;
+        const XMLNode* data_; // Children as of when the index was built
+        size_t size_;
+        std::vector<std::pair<size_t, size_t>> entries_; // Name hash, position
+    };
+
+    struct XMLResult;
+
+    /**
+     * @brief Caller-owned memo of resolved path -> node
+     *
+     * For code that looks up the same string paths in one parse result
+     * many times. Entries are tied to the result's generation, which
+     * changes whenever the result is constructed or assigned, so using
+     * the cache with another result, or with one that was assigned a new
+     * tree, drops the entries. Entries point into the tree, so the cache
+     * does not notice edits to the nodes: call clear() after changing
+     * them. Safe for concurrent readers.
+     */
+    class XMLPathCache {
+    public:
+        static constexpr size_t kMaxEntries = 1024;
+
+        XMLPathCache() = default;
+        XMLPathCache(const XMLPathCache&) = delete;
+        XMLPathCache& operator=(const XMLPathCache&) = delete;
+
+        /**
+         * @brief Find the node a path leads to, resolving it on first use
+         * @param result The result whose root the path starts from
+         * @param path The dotted path
+         * @return Pointer to the node or nullptr if not found
+         */
+        const XMLNode* resolve(const XMLResult& result, const std::string& path);
+
+        /**
+         * @brief Drop all entries
+         */
+        void clear();
+
+    private:
+        std::shared_mutex mutex_;
+        uint64_t generation_ = 0; // Generation of the result the entries belong to, 0 for none
+        std::unordered_map<std::string, const XMLNode*> nodes_;
     };
 
     /**
      * @brief Result structure for XML parsing operations
+     *
+     * When parsed with XMLParseOptions::use_arena, the tree under root is
+     * allocated from an arena the result owns. Since nothing in the tree
+     * owns memory outside the arena, the result hands the arena's blocks
+     * back to the parser without visiting the nodes. Copies of the result
+     * or of its nodes are allocated normally; nodes moved out of it must
+     * not outlive it.
      */
     struct XMLResult {
         bool success = false;
         std::string error_message;
+        ErrorLocation error_location;
+
+    private:
+        struct Arena;
+        struct ArenaBlocks;
+
+        // Declared before root, so the tree is destroyed while its memory is still there
+        std::unique_ptr<Arena> arena_;
+
+        // Changes whenever the result is constructed or assigned, for XMLPathCache
+        uint64_t generation_ = next_generation();
+
+    public:
         XMLNode root;
+
+        XMLResult();
+        XMLResult(const XMLResult& other);
+        XMLResult(XMLResult&& other) noexcept;
+        ~XMLResult();
+        XMLResult& operator=(const XMLResult& other);
+        XMLResult& operator=(XMLResult&& other) noexcept;
         
         /**
          * @brief Get value by path (e.g., "config.database.host")
@@ -125,6 +557,116 @@ namespace parser {
          * @return Vector of attribute names
          */
         std::vector<std::string> get_attributes(const std::string& path) const;
+
+        /**
+         * @brief Get value by precompiled path
+         * @param path The compiled path to the value
+         * @param default_value Default value if not found
+         * @return The value as string
+         */
+        std::string get_value(const XMLPath& path, const std::string& default_value = "") const;
+
+        /**
+         * @brief Get attribute value by precompiled path
+         * @param path The compiled path to the node
+         * @param attr_name The attribute name
+         * @param default_value Default value if not found
+         * @return The attribute value
+         */
+        std::string get_attribute(const XMLPath& path, const std::string& attr_name, const std::string& default_value = "") const;
+
+        /**
+         * @brief Get node by precompiled path
+         * @param path The compiled path to the node
+         * @return Pointer to the node or nullptr if not found
+         */
+        const XMLNode* get_node(const XMLPath& path) const;
+
+        /**
+         * @brief Check if precompiled path exists
+         * @param path The compiled path to check
+         * @return True if path exists
+         */
+        bool has_path(const XMLPath& path) const;
+
+    private:
+        friend class XMLParser;
+        friend class XMLPathCache;
+
+        explicit XMLResult(std::shared_ptr<ArenaBlocks> blocks);
+
+        /**
+         * @brief Draw a generation no result has had, never 0
+         */
+        static uint64_t next_generation();
+
+        /**
+         * @brief End the tree without visiting it if the arena holds all of it
+         */
+        void release_tree();
+    };
+
+    /**
+     * @brief Result structure for event-based XML parsing
+     */
+    struct XMLEventResult {
+        bool success = false;
+        std::string error_message;
+        ErrorLocation error_location;
+    };
+
+    /**
+     * @brief Base class for XMLParser::parse_events handlers
+     *
+     * Provides empty callbacks, so a handler only defines the events it
+     * cares about. Calls are resolved at compile time; nothing here is
+     * virtual. All views point into the parsed input and text is passed
+     * as written, so entities are only decoded when decode() is called.
+     */
+    struct XMLHandler {
+        void start_element(std::string_view /*name*/, const std::vector<XMLReader::Attribute>& /*attributes*/) {}
+        void end_element(std::string_view /*name*/) {}
+        void text(std::string_view /*raw_text*/) {}
+        void cdata(std::string_view /*data*/) {}
+        void comment(std::string_view /*data*/) {}
+        void processing_instruction(std::string_view /*target*/, std::string_view /*data*/) {}
+
+        /**
+         * @brief Decode entity references in raw text or attribute values
+         * @param raw The text as written in the input
+         * @return The decoded text
+         */
+        static std::string decode(std::string_view raw);
+
+        /**
+         * @brief Decode entity references, appending to a buffer
+         * @param raw The text as written in the input
+         * @param out Output buffer the decoded text is appended to
+         */
+        static void decode(std::string_view raw, std::string& out);
+    };
+
+    /**
+     * @brief Options for XMLParser
+     */
+    struct XMLParseOptions {
+        // Keep text, CDATA, comments and processing instructions inside
+        // elements as content nodes, so to_string() reproduces them
+        bool preserve_content = false;
+
+        // Resolve element and attribute prefixes to namespace URIs;
+        // an undeclared prefix is then an error
+        bool resolve_namespaces = false;
+
+        // Resource limits, all unlimited by default
+        XMLLimits limits;
+
+        // Allocate the tree of parse() and parse_file() from an arena
+        // owned by the result, instead of one allocation per string and
+        // child list. Small pieces the tree frees are only returned, all at
+        // once, when the result is destroyed, and the parser keeps the
+        // arena's blocks for its next parse until the parser is destroyed.
+        bool use_arena = false;
     };
 
     /**
@@ -139,6 +681,16 @@ namespace parser {
      */
     class XMLParser {
     public:
+        /**
+         * @brief Callback receiving one child element of the root
+         *
+         * The record is detached from the tree and may be moved from.
+         */
+        using RecordFunction = std::function<void(XMLNode& record)>;
+
+        XMLParser() = default;
+        explicit XMLParser(const XMLParseOptions& options) : options_(options) {}
+
         /**
          * @brief Parse XML content from string
          * @param content The XML content as string
@@ -152,6 +704,59 @@ namespace parser {
          * @return XMLResult with parsed data or error information
          */
         XMLResult parse_file(const std::string& filename);
+
+        /**
+         * @brief Parse a large XML document using several threads
+         *
+         * The children of the root element are split into balanced chunks
+         * at top-level start tags, and the chunks are parsed concurrently.
+         * Documents with a single chunk, and inputs too small to benefit,
+         * are parsed with parse().
+         *
+         * @param content The XML content as string
+         * @param thread_count Number of threads, 0 for the hardware concurrency
+         * @return XMLResult with parsed data or error information
+         */
+        XMLResult parse_parallel(const std::string& content, size_t thread_count = 0);
+
+        /**
+         * @brief Parse the root's child elements in parallel and pass them to a callback
+         *
+         * Records are delivered on the calling thread in document order.
+         * Only a few chunks per thread are held in memory at a time, so a
+         * wrapper around millions of records is never built as one tree.
+         * Content nodes directly inside the root are not reported. After
+         * an error, the records before it have already been delivered.
+         *
+         * @param content The XML content as string
+         * @param on_record Called once per child element of the root
+         * @param thread_count Number of threads, 0 for the hardware concurrency
+         * @return XMLResult whose root is the wrapper element without children
+         */
+        XMLResult parse_records(const std::string& content, const RecordFunction& on_record, size_t thread_count = 0);
+        
+        /**
+         * @brief Parse XML content and report it to a handler as events
+         *
+         * No tree is built and no strings are copied: names, text and
+         * attribute values are passed as views into the input. The
+         * handler usually derives from XMLHandler.
+         *
+         * @param input The XML content
+         * @param handler The event handler
+         * @return XMLEventResult with success flag or error information
+         */
+        template <typename Handler>
+        XMLEventResult parse_events(std::string_view input, Handler& handler);
+
+        /**
+         * @brief Parse a memory-mapped XML file and report it as events
+         * @param filename The path to the XML file
+         * @param handler The event handler
+         * @return XMLEventResult with success flag or error information
+         */
+        template <typename Handler>
+        XMLEventResult parse_events_file(const std::string& filename, Handler& handler);
         
         /**
          * @brief Convert parsed data back to XML format
@@ -179,47 +784,158 @@ namespace parser {
         const XMLNode* get_node_by_path(const XMLNode& root, const std::string& path) const;
 
     private:
+        /**
+         * @brief Build an error status
+         * @param message The error description
+         * @return Failed status, so callers can write "return fail(...)"
+         */
+        static ParseStatus fail(const std::string& message);
+
+        /**
+         * @brief Skip the prolog and parse the root element
+         * @param content The XML content
+         * @param pos Current position in the content
+         * @param root The node to populate
+         * @return Empty status if successful, otherwise the error
+         */
+        ParseStatus parse_document(const std::string& content, size_t& pos, XMLNode& root);
+
+        /**
+         * @brief Skip the XML declaration, DOCTYPE, comments and processing instructions before the root element
+         * @param content The XML content
+         * @param pos Current position in the content
+         * @return True if a root element follows
+         */
+        ParseStatus parse_prolog(const std::string& content, size_t& pos);
+
+        /**
+         * @brief Check that only whitespace, comments and processing instructions follow the root element
+         * @param content The XML content
+         * @param pos Position after the root element
+         * @return Empty status if successful, otherwise the error
+         */
+        ParseStatus parse_epilog(const std::string& content, size_t& pos);
+
+        /**
+         * @brief Parse the root element, splitting its children into chunks
+         * @param content The XML content
+         * @param thread_count Number of threads
+         * @param chunk_size Approximate size of one chunk in bytes
+         * @param on_record Receives the child elements, or nullptr to build the tree
+         * @return XMLResult with parsed data or error information
+         */
+        XMLResult parse_split(const std::string& content, size_t thread_count, size_t chunk_size, const RecordFunction* on_record);
+
+        /**
+         * @brief Parse chunks of the root's content concurrently, a round of thread_count at a time
+         * @param content The XML content
+         * @param splits Chunk boundaries from the structural pre-scan
+         * @param thread_count Number of threads
+         * @param root The root element
+         * @param on_record Receives the child elements, or nullptr to append them to root
+         * @param pos Receives the error position on failure
+         * @return Empty status if successful, otherwise the error
+         */
+        ParseStatus parse_chunks(const std::string& content, const std::vector<size_t>& splits, size_t thread_count,
+                                 XMLNode& root, const RecordFunction* on_record, size_t& pos);
+
         /**
          * @brief Parse XML node from string
          * @param content The XML content
          * @param pos Current position in the content
+         * @param node The node to populate
          * @param parent Parent node
-         * @return Parsed XML node
+         * @return Empty status if successful, otherwise the error
+         */
+        ParseStatus parse_node(const std::string& content, size_t& pos, XMLNode& node, XMLNode* parent = nullptr);
+
+        /**
+         * @brief Parse a start tag, opening the element's namespace scope
+         * @param content The XML content
+         * @param pos Position of the '<'
+         * @param node The node to populate
+         * @param self_closing Set if the tag ends with "/>"
+         * @return Empty status if successful, otherwise the error
          */
-        XMLNode parse_node(const std::string& content, size_t& pos, XMLNode* parent = nullptr);
+        ParseStatus parse_start_tag(const std::string& content, size_t& pos, XMLNode& node, bool& self_closing);
+
+        /**
+         * @brief Parse text, markup and child elements up to a closing tag
+         *
+         * Nested elements are parsed with an explicit stack of open
+         * elements rather than by recursion, so the nesting depth of the
+         * input is not limited by the call stack.
+         *
+         * @param content The XML content
+         * @param pos Current position; left at the closing tag or at end
+         * @param end Position where the content stops at the latest
+         * @param node The element receiving the content
+         * @param text_content Receives the text
+         * @param has_elements Set if a child element was parsed
+         * @return Empty status if successful, otherwise the error
+         */
+        ParseStatus parse_content(const std::string& content, size_t& pos, size_t end, XMLNode& node,
+                                  std::pmr::string& text_content, bool& has_elements);
+
+        /**
+         * @brief Parse the closing tag of an element
+         * @param content The XML content
+         * @param pos Position of the "</"
+         * @param node The element being closed
+         * @return Empty status if the name matches, otherwise the error
+         */
+        ParseStatus parse_closing_tag(const std::string& content, size_t& pos, const XMLNode& node);
         
         /**
          * @brief Parse XML element tag
          * @param content The XML content
          * @param pos Current position in the content
          * @param node The node to populate
-         * @return True if parsing was successful
+         * @return Empty status if successful, otherwise the error
          */
-        bool parse_element_tag(const std::string& content, size_t& pos, XMLNode& node);
+        ParseStatus parse_element_tag(const std::string& content, size_t& pos, XMLNode& node);
         
         /**
          * @brief Parse XML attributes
          * @param content The XML content
          * @param pos Current position in the content
          * @param node The node to populate
+         * @return Empty status if successful, otherwise the error
          */
-        void parse_attributes(const std::string& content, size_t& pos, XMLNode& node);
+        ParseStatus parse_attributes(const std::string& content, size_t& pos, XMLNode& node);
         
         /**
-         * @brief Parse XML attribute value
+         * @brief Parse comments, CDATA and processing instructions inside an element
          * @param content The XML content
-         * @param pos Current position in the content
-         * @return The attribute value
+         * @param pos Position of the '<' that starts the markup
+         * @param node The element containing the markup
+         * @param text_content Receives CDATA text
+         * @return Empty status if successful, otherwise the error
          */
-        std::string parse_attribute_value(const std::string& content, size_t& pos);
-        
+        ParseStatus parse_markup(const std::string& content, size_t& pos, XMLNode& node, std::pmr::string& text_content);
+
         /**
-         * @brief Parse XML text content
-         * @param content The XML content
-         * @param pos Current position in the content
-         * @return The text content
+         * @brief Append a content node spanning part of the input
+         * @param node The parent element
+         * @param type The content type
+         * @param start Offset of the content in the input
+         * @param end Offset just past the content
          */
-        std::string parse_text_content(const std::string& content, size_t& pos);
+        void add_content(XMLNode& node, XMLNode::Type type, size_t start, size_t end);
+
+        /**
+         * @brief Open the namespace scope of an element and resolve its names
+         * @param node The element, with its attributes parsed
+         * @return Empty status if successful, otherwise the error
+         */
+        ParseStatus resolve_namespaces(XMLNode& node);
+
+        /**
+         * @brief Get the shared string for an interned namespace URI
+         * @param id The URI ID from namespaces_
+         * @return The URI string, or nullptr for no namespace
+         */
+        const std::shared_ptr<const std::pmr::string>& namespace_string(uint32_t id);
         
         /**
          * @brief Skip whitespace characters
@@ -232,38 +948,102 @@ namespace parser {
          * @brief Skip XML comments
          * @param content The XML content
          * @param pos Current position in the content
+         * @return Empty status if successful, otherwise the error
          */
-        void skip_comments(const std::string& content, size_t& pos);
+        ParseStatus skip_comments(const std::string& content, size_t& pos);
         
         /**
          * @brief Skip XML processing instructions
          * @param content The XML content
          * @param pos Current position in the content
+         * @return Empty status if successful, otherwise the error
          */
-        void skip_processing_instructions(const std::string& content, size_t& pos);
-        
-        /**
-         * @brief Convert XML node to string representation
-         * @param node The XML node to convert
-         * @param indent Current indentation level
-         * @param pretty_print Whether to format with indentation
-         * @return String representation
-         */
-        std::string node_to_string(const XMLNode& node, int indent = 0, bool pretty_print = false);
-        
+        ParseStatus skip_processing_instructions(const std::string& content, size_t& pos);
+
         /**
-         * @brief Split path into components
-         * @param path The path to split
-         * @return Vector of path components
+         * @brief Skip a document type declaration, including its internal subset
+         * @param content The XML content
+         * @param pos Current position in the content
+         * @return Empty status if successful, otherwise the error
          */
-        std::vector<std::string> split_path(const std::string& path) const;
+        ParseStatus skip_doctype(const std::string& content, size_t& pos);
         
         /**
-         * @brief Trim whitespace from string
-         * @param str The string to trim
-         * @return Trimmed string
+         * @brief Forward reader events to a handler until the document ends
+         * @param reader The reader positioned before the first event
+         * @param handler The event handler
+         * @return XMLEventResult with success flag or error information
          */
-        std::string trim(const std::string& str);
+        template <typename Handler>
+        XMLEventResult dispatch_events(XMLReader& reader, Handler& handler);
+
+        XMLParseOptions options_;
+
+        // Elements parsed so far, checked against options_.limits.max_elements
+        size_t element_count_ = 0;
+
+        // Memory resource of the tree being built, for the strings its nodes share
+        std::pmr::memory_resource* resource_ = xml_heap_resource();
+
+        // Input shared by the content nodes of the document being parsed
+        std::shared_ptr<const std::pmr::string> source_;
+
+        // Namespace scopes of the open elements, and one string per URI ID
+        XMLNamespaceScope namespaces_;
+        std::vector<std::shared_ptr<const std::pmr::string>> namespace_strings_;
+
+        // Memory of the arenas of released results, for use_arena
+        std::shared_ptr<XMLResult::ArenaBlocks> arena_blocks_;
     };
 
+    template <typename Handler>
+    XMLEventResult XMLParser::parse_events(std::string_view input, Handler& handler) {
+        XMLReader reader;
+        reader.set_limits(options_.limits);
+        reader.open_buffer(input);
+        return dispatch_events(reader, handler);
+    }
+
+    template <typename Handler>
+    XMLEventResult XMLParser::parse_events_file(const std::string& filename, Handler& handler) {
+        XMLReader reader;
+        reader.set_limits(options_.limits);
+        reader.open(filename);
+        return dispatch_events(reader, handler);
+    }
+
+    template <typename Handler>
+    XMLEventResult XMLParser::dispatch_events(XMLReader& reader, Handler& handler) {
+        XMLEventResult result;
+        while (true) {
+            switch (reader.next()) {
+                case XMLReader::Event::StartElement:
+                    handler.start_element(reader.name(), reader.attributes());
+                    break;
+                case XMLReader::Event::EndElement:
+                    handler.end_element(reader.name());
+                    break;
+                case XMLReader::Event::Text:
+                    handler.text(reader.raw_text());
+                    break;
+                case XMLReader::Event::CData:
+                    handler.cdata(reader.raw_text());
+                    break;
+                case XMLReader::Event::Comment:
+                    handler.comment(reader.raw_text());
+                    break;
+                case XMLReader::Event::ProcessingInstruction:
+                    handler.processing_instruction(reader.name(), reader.raw_text());
+                    break;
+                case XMLReader::Event::EndDocument:
+                    result.success = true;
+                    return result;
+                case XMLReader::Event::Error:
+                    result.error_message = reader.error_message();
+                    result.error_location = reader.error_location();
+                    return result;
+            }
+        }
+    }
+
 } // namespace parser 
\ No newline at end of file
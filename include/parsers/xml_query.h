@@ -0,0 +1,222 @@
+#pragma once
+
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include <iterator>
+#include "parsers/xml_parser.h"
+
+namespace parser {
+
+    /**
+     * @brief Compiled query over an XMLNode tree, using a subset of XPath
+     *
+     * Supported syntax:
+     * - /a/b     child steps from the document root
+     * - a/b      child steps from the context node
+     * - //item   descendants at any depth, in document order
+     * - *        any element name, . the context node
+     * - [n]      n-th match among siblings, 1-based; //item[n] counts
+     *            within each parent
+     * - [@id]    element has the attribute
+     * - [@id='x'] attribute equals a value
+     * - [text()='x'] element text equals a value
+     * - text()   as the last step, selects element text
+     * - @attr    as the last step, selects an attribute value
+     *
+     * A query is compiled once and can be evaluated against any number
+     * of trees. Evaluation is lazy: matches are produced one at a time
+     * while iterating, without building intermediate node vectors.
+     */
+    class XMLQuery {
+    public:
+        bool success = false;
+        std::string error_message;
+
+        class Iterator;
+        class Range;
+
+        /**
+         * @brief Compile a query expression
+         * @param expression The query, e.g. "/catalog/item[@id='x']/price"
+         * @return XMLQuery ready for evaluation or error information
+         */
+        static XMLQuery compile(const std::string& expression);
+
+        /**
+         * @brief Evaluate the query
+         *
+         * Absolute queries treat the context as the document root
+         * element; relative queries start at the context node.
+         *
+         * @param context The root or context node
+         * @return Lazy range of matching nodes
+         */
+        Range select(const XMLNode& context) const;
+
+        /**
+         * @brief Evaluate the query against a parsed document
+         * @param result The parsed XML result
+         * @return Lazy range of matching nodes
+         */
+        Range select(const XMLResult& result) const;
+
+        /**
+         * @brief Get the first matching node
+         * @param context The root or context node
+         * @return Pointer to the node or nullptr if nothing matches
+         */
+        const XMLNode* first(const XMLNode& context) const;
+
+        /**
+         * @brief Get the value of the first match
+         * @param context The root or context node
+         * @param default_value Default value if nothing matches
+         * @return Attribute value for @attr queries, otherwise element text
+         */
+        std::string first_value(const XMLNode& context, const std::string& default_value = "") const;
+
+    private:
+        enum class Axis {
+            Child,
+            Descendant,       // A // step fused with the element step after it
+            DescendantOrSelf, // The walk of //., which selects the nodes themselves
+            Self
+        };
+
+        enum class Output {
+            Node,
+            Text,
+            Attribute
+        };
+
+        struct Predicate {
+            enum class Kind {
+                Position,
+                HasAttribute,
+                AttributeEquals,
+                TextEquals
+            };
+            Kind kind = Kind::Position;
+            size_t position = 0;
+            std::string name;
+            std::string value;
+        };
+
+        struct Step {
+            Axis axis = Axis::Child;
+            std::string name; // Empty matches any element
+            bool nested = false; // A // step after another, whose walks can overlap
+            size_t first_predicate = 0;
+            size_t predicate_count = 0;
+        };
+
+        bool parse(const std::string& expression);
+        bool parse_predicate(const std::string& expression, size_t& pos);
+        bool fail(const std::string& expression, size_t pos, const std::string& message);
+        bool matches(const Step& step, const XMLNode& node, size_t* counters) const;
+
+        bool absolute_ = false;
+        std::vector<Step> steps_;
+        std::vector<Predicate> predicates_;
+        Output output_ = Output::Node;
+        std::string output_attribute_;
+    };
+
+    /**
+     * @brief Forward iterator over query matches
+     *
+     * Keeps one cursor per query step plus a sibling stack for // steps;
+     * both are allocated when iteration starts and reused while advancing.
+     * A // step tests each node as its pre-order walk reaches it, so its
+     * matches come in document order; [n] counters live on the sibling
+     * stack, one set per parent. A // step after another remembers the
+     * contexts it has walked and skips those inside one, so no node is
+     * reported twice. A child step after a // step still lists the
+     * children of each context in turn: //a/b yields the b children of
+     * an outer a before those of an a nested in it.
+     */
+    class XMLQuery::Iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = XMLNode;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const XMLNode*;
+        using reference = const XMLNode&;
+
+        Iterator() = default;
+
+        reference operator*() const { return *current_; }
+        pointer operator->() const { return current_; }
+        Iterator& operator++();
+        Iterator operator++(int);
+
+        bool operator==(const Iterator& other) const { return current_ == other.current_; }
+        bool operator!=(const Iterator& other) const { return current_ != other.current_; }
+
+        /**
+         * @brief Get the value selected for the current match
+         * @return Attribute value for @attr queries, otherwise element text
+         */
+        const std::pmr::string& value() const;
+
+    private:
+        friend class XMLQuery;
+
+        // Cursor of one query step; a null context stands for the document
+        struct Frame {
+            const XMLNode* context = nullptr;
+            const XMLNode* next = nullptr; // Child steps: remaining siblings
+            const XMLNode* end = nullptr;
+            size_t stack_base = 0;         // Descendant steps: start of their part of stack_
+            bool started = false;
+            std::unordered_set<const XMLNode*> walked; // Nested descendant steps: contexts walked
+        };
+
+        // Remaining siblings at one level of a descendant walk
+        struct Siblings {
+            const XMLNode* next;
+            const XMLNode* end;
+            size_t counters; // Start of this level's [n] counters in walk_counters_
+        };
+
+        Iterator(const XMLQuery* query, const XMLNode* root, const XMLNode* context);
+
+        void enter(size_t level, const XMLNode* context);
+        void push_siblings(const XMLNode* first, const XMLNode* last, size_t counters);
+        void pop_siblings();
+        bool produce(size_t level, const XMLNode*& node);
+        void advance();
+
+        const XMLQuery* query_ = nullptr;
+        const XMLNode* root_ = nullptr;
+        const XMLNode* current_ = nullptr;
+        std::vector<Frame> frames_;
+        std::vector<Siblings> stack_;
+        std::vector<size_t> counters_;
+        std::vector<size_t> walk_counters_;
+        size_t level_ = 0;
+    };
+
+    /**
+     * @brief Lazy range of query matches
+     *
+     * Refers to the query and the tree; both must outlive the range.
+     */
+    class XMLQuery::Range {
+    public:
+        Iterator begin() const { return Iterator(query_, root_, context_); }
+        Iterator end() const { return Iterator(); }
+        bool empty() const { return begin() == end(); }
+
+    private:
+        friend class XMLQuery;
+
+        Range(const XMLQuery* query, const XMLNode* root, const XMLNode* context) : query_(query), root_(root), context_(context) {}
+
+        const XMLQuery* query_;
+        const XMLNode* root_;
+        const XMLNode* context_;
+    };
+
+} // namespace parser
@@ -0,0 +1,332 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <functional>
+#include <istream>
+#include "parsers/parse_error.h"
+#include "parsers/xml_limits.h"
+#include "parsers/mapped_file.h"
+#include "parsers/xml_namespaces.h"
+
+namespace parser {
+
+    /**
+     * @brief Streaming pull parser for XML
+     *
+     * The reader walks the input one event at a time and never builds a
+     * tree. Names, text and attribute values are returned as views into
+     * the input and stay valid until the next call to next(). Memory use
+     * is bounded by the largest single token plus one read chunk, so
+     * documents far larger than memory can be processed.
+     *
+     * Input can be a memory-mapped file, a buffer owned by the caller, an
+     * input stream or a read callback delivering the input in chunks.
+     *
+     * With set_namespace_aware(true), xmlns declarations are tracked per
+     * open element and the namespace of every element and attribute is
+     * resolved; an undeclared prefix is an error.
+     *
+     * A DOCTYPE declaration before the root element is skipped without an
+     * event. After the root element only whitespace, comments and
+     * processing instructions may follow.
+     */
+    class XMLReader {
+    public:
+        enum class Event {
+            StartElement,
+            EndElement,
+            Text,
+            CData,
+            Comment,
+            ProcessingInstruction,
+            EndDocument,
+            Error
+        };
+
+        /**
+         * @brief Callback reading the next chunk of input
+         *
+         * Receives a buffer and its size, returns the number of bytes
+         * written. Returning 0 signals the end of the input.
+         */
+        using ReadFunction = std::function<size_t(char* buffer, size_t size)>;
+
+        /**
+         * @brief Attribute of the current element, as written in the input
+         *
+         * The value is the text between the quotes with entities not yet
+         * decoded.
+         */
+        struct Attribute {
+            std::string_view name;
+            std::string_view value;
+        };
+
+        static constexpr size_t kDefaultChunkSize = 64 * 1024;
+
+        XMLReader() = default;
+
+        XMLReader(const XMLReader&) = delete;
+        XMLReader& operator=(const XMLReader&) = delete;
+
+        /**
+         * @brief Read from a memory-mapped file
+         * @param filename The path to the XML file
+         * @return True if the file could be mapped
+         */
+        bool open(const std::string& filename);
+
+        /**
+         * @brief Read from a buffer owned by the caller
+         * @param content The XML content, which must outlive the reader
+         */
+        void open_buffer(std::string_view content);
+
+        /**
+         * @brief Read from an input stream in chunks
+         * @param stream The input stream, which must outlive the reader
+         * @param chunk_size Number of bytes read at a time
+         */
+        void open_stream(std::istream& stream, size_t chunk_size = kDefaultChunkSize);
+
+        /**
+         * @brief Read from a callback in chunks
+         * @param read The read callback
+         * @param chunk_size Number of bytes requested at a time
+         */
+        void open_source(ReadFunction read, size_t chunk_size = kDefaultChunkSize);
+
+        /**
+         * @brief Advance to the next event
+         *
+         * A self-closing element produces a StartElement followed by an
+         * EndElement. After the root element is closed the reader reports
+         * EndDocument; after a failure it keeps reporting Error.
+         *
+         * @return The new current event
+         */
+        Event next();
+
+        /**
+         * @brief Get the current event
+         * @return The event returned by the last call to next()
+         */
+        Event event() const { return event_; }
+
+        /**
+         * @brief Get the element name or processing instruction target
+         * @return Name of the current element or instruction
+         */
+        std::string_view name() const { return name_; }
+
+        /**
+         * @brief Get the current text without decoding entities
+         * @return Text, CDATA content, comment or instruction data
+         */
+        std::string_view raw_text() const { return text_; }
+
+        /**
+         * @brief Get the current text with entities decoded
+         *
+         * Only Text events contain entity references; other events are
+         * returned as written.
+         *
+         * @return The text
+         */
+        std::string text() const;
+
+        /**
+         * @brief Get the nesting depth of the current event
+         *
+         * The root element and its direct content are at depth 1.
+         *
+         * @return Number of enclosing elements, counting the current one
+         */
+        size_t depth() const { return depth_; }
+
+        /**
+         * @brief Check if the current element was written as <name/>
+         * @return True for the StartElement and EndElement of such a tag
+         */
+        bool is_empty_element() const { return empty_element_; }
+
+        // Attributes of the current StartElement, in document order
+        const std::vector<Attribute>& attributes() const { return attributes_; }
+        size_t attribute_count() const { return attributes_.size(); }
+        std::string_view attribute_name(size_t index) const { return attributes_[index].name; }
+        std::string_view raw_attribute_value(size_t index) const { return attributes_[index].value; }
+        std::string attribute_value(size_t index) const;
+
+        /**
+         * @brief Get attribute value of the current element
+         * @param attr_name The attribute name
+         * @param default_value Default value if attribute not found
+         * @return The attribute value with entities decoded
+         */
+        std::string get_attribute(std::string_view attr_name, const std::string& default_value = "") const;
+
+        /**
+         * @brief Check if the current element has an attribute
+         * @param attr_name The attribute name
+         * @return True if attribute exists
+         */
+        bool has_attribute(std::string_view attr_name) const;
+
+        /**
+         * @brief Enable namespace resolution for the following documents
+         * @param enabled True to resolve prefixes to namespace URIs
+         */
+        void set_namespace_aware(bool enabled) { namespace_aware_ = enabled; }
+
+        bool namespace_aware() const { return namespace_aware_; }
+
+        /**
+         * @brief Set resource limits for the following documents
+         *
+         * Text and CDATA are checked while they are read, so a long run
+         * of text stops the reader before the window grows past the limit.
+         *
+         * @param limits The limits; 0 leaves a limit unset
+         */
+        void set_limits(const XMLLimits& limits) { limits_ = limits; }
+
+        /**
+         * @brief Get the namespace URI of the current element
+         *
+         * Valid for StartElement and EndElement when namespace aware.
+         *
+         * @return The URI, empty if the element has no namespace
+         */
+        std::string_view namespace_uri() const { return namespaces_.uri(namespace_); }
+
+        /**
+         * @brief Get the name of the current element without its prefix
+         * @return The local name
+         */
+        std::string_view local_name() const { return XMLNamespaceScope::local_name(name_); }
+
+        // Namespaces of the attributes of the current StartElement
+        std::string_view attribute_namespace_uri(size_t index) const { return namespaces_.uri(attribute_namespaces_[index]); }
+        std::string_view attribute_local_name(size_t index) const { return XMLNamespaceScope::local_name(attributes_[index].name); }
+
+        /**
+         * @brief Get the interned namespace IDs of the current element and its attributes
+         *
+         * IDs index namespaces() and are XMLNamespaceScope::npos for no
+         * namespace. They stay stable for the lifetime of the reader.
+         */
+        uint32_t namespace_id() const { return namespace_; }
+        uint32_t attribute_namespace_id(size_t index) const { return attribute_namespaces_[index]; }
+        const XMLNamespaceScope& namespaces() const { return namespaces_; }
+
+        /**
+         * @brief Get the byte offset of the current event in the input
+         * @return Offset of the first byte of the current token
+         */
+        size_t offset() const { return token_offset_; }
+
+        /**
+         * @brief Get the error description after an Error event
+         * @return The error message
+         */
+        const std::string& error_message() const { return error_message_; }
+
+        /**
+         * @brief Get the error position after an Error event
+         * @return The error location
+         */
+        const ErrorLocation& error_location() const { return error_location_; }
+
+    private:
+        void reset();
+        Event fail(const std::string& message, size_t at);
+
+        /**
+         * @brief Read more input, discarding everything before the current token
+         * @return False at the end of the input
+         */
+        bool fill();
+
+        /**
+         * @brief Make sure the window holds count bytes from the token start
+         * @return False if the input ends first
+         */
+        bool ensure(size_t count);
+
+        /**
+         * @brief Find a delimiter at or after token offset from
+         * @param limit Stop reading once the window holds more than limit bytes
+         * @return Offset relative to the token start, or npos at end of input or past the limit
+         */
+        size_t find(size_t from, std::string_view delimiter, size_t limit = std::string_view::npos);
+
+        /**
+         * @brief Skip the DOCTYPE declaration at the token start
+         * @return True if successful, otherwise the reader is in the Error state
+         */
+        bool skip_doctype();
+
+        Event read_markup();
+        Event read_start_tag();
+        Event read_end_tag();
+        Event read_text();
+
+        /**
+         * @brief Open the scope of the current start tag and resolve its names
+         * @return True if successful, otherwise the reader is in the Error state
+         */
+        bool resolve_namespaces();
+
+        std::string_view window() const { return std::string_view(data_ + pos_, size_ - pos_); }
+
+        // Input window; pos_ is the start of the current token
+        const char* data_ = nullptr;
+        size_t size_ = 0;
+        size_t pos_ = 0;
+        size_t base_ = 0; // Absolute offset of data_[0]
+
+        // Chunked input
+        MappedFile file_;
+        ReadFunction read_;
+        std::string buffer_;
+        size_t chunk_size_ = kDefaultChunkSize;
+        bool eof_ = true;
+
+        // Line tracking for error locations over discarded input
+        size_t discarded_lines_ = 0;
+        size_t discarded_line_start_ = 0;
+
+        // Current event
+        Event event_ = Event::EndDocument;
+        std::string_view name_;
+        std::string_view text_;
+        std::vector<Attribute> attributes_;
+        size_t depth_ = 0;
+        size_t token_offset_ = 0;
+        bool empty_element_ = false;
+
+        // Names of the open elements, stored back to back
+        std::string open_names_;
+        std::vector<size_t> open_name_ends_;
+        bool pending_end_ = false;
+        bool root_seen_ = false;
+        bool doctype_seen_ = false;
+
+        XMLLimits limits_;
+        size_t element_count_ = 0;
+
+        // Namespace resolution
+        bool namespace_aware_ = false;
+        XMLNamespaceScope namespaces_;
+        uint32_t namespace_ = XMLNamespaceScope::npos;
+        std::vector<uint32_t> attribute_namespaces_;
+        bool pending_pop_ = false; // Scope of the last EndElement is still open
+        std::string decoded_uri_;
+
+        std::string error_message_;
+        ErrorLocation error_location_;
+    };
+
+} // namespace parser
@@ -0,0 +1,257 @@
+#pragma once
+
+#include <memory_resource>
+#include <string>
+#include <string_view>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PARSER_XML_SSE2 1
+#include <emmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+namespace parser {
+namespace detail {
+
+#ifdef PARSER_XML_SSE2
+    inline int lowest_set_bit(unsigned int mask) {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return static_cast<int>(index);
+#else
+        return __builtin_ctz(mask);
+#endif
+    }
+#endif
+
+    /**
+     * @brief Find the first byte equal to any of the given characters
+     *
+     * Compares 16 bytes at a time with SSE2 where available, so long runs
+     * without any of the characters are skipped quickly.
+     *
+     * @param pos Start of the range
+     * @param end End of the range
+     * @param chars The characters to look for
+     * @return Pointer to the first match, or end if there is none
+     */
+    template <typename... Chars>
+    inline const char* find_any(const char* pos, const char* end, Chars... chars) {
+#ifdef PARSER_XML_SSE2
+        const __m128i needles[] = {_mm_set1_epi8(chars)...};
+        while (end - pos >= 16) {
+            __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pos));
+            __m128i hits = _mm_setzero_si128();
+            for (const __m128i& needle : needles) {
+                hits = _mm_or_si128(hits, _mm_cmpeq_epi8(block, needle));
+            }
+            unsigned int mask = static_cast<unsigned int>(_mm_movemask_epi8(hits));
+            if (mask != 0) {
+                return pos + lowest_set_bit(mask);
+            }
+            pos += 16;
+        }
+#endif
+        for (; pos < end; ++pos) {
+            char c = *pos;
+            if (((c == chars) || ...)) {
+                return pos;
+            }
+        }
+        return end;
+    }
+
+    // Character classes, combined as bits in kCharClasses
+    enum CharClass : unsigned char {
+        kSpace = 1,            // XML whitespace: space, tab, CR, LF
+        kElementNameEnd = 2,   // Ends an element name: whitespace, '>', '/'
+        kAttributeNameEnd = 4, // Ends an attribute name: also '='
+        kNameStart = 8,        // May start a name: letters, '_', ':', non-ASCII bytes
+        kNameChar = 16         // May continue a name: also digits, '-', '.'
+    };
+
+    struct CharClassTable {
+        unsigned char classes[256];
+    };
+
+    constexpr CharClassTable make_char_classes() {
+        CharClassTable table{};
+        const char spaces[] = {' ', '\t', '\r', '\n'};
+        for (char c : spaces) {
+            table.classes[static_cast<unsigned char>(c)] = kSpace | kElementNameEnd | kAttributeNameEnd;
+        }
+        table.classes[static_cast<unsigned char>('>')] = kElementNameEnd | kAttributeNameEnd;
+        table.classes[static_cast<unsigned char>('/')] = kElementNameEnd | kAttributeNameEnd;
+        table.classes[static_cast<unsigned char>('=')] = kAttributeNameEnd;
+        // ASCII part of the XML Name production; bytes of UTF-8 sequences
+        // are accepted without checking the code point ranges
+        for (int c = 0; c < 256; ++c) {
+            if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' || c == ':' || c >= 0x80) {
+                table.classes[c] |= kNameStart | kNameChar;
+            } else if ((c >= '0' && c <= '9') || c == '-' || c == '.') {
+                table.classes[c] |= kNameChar;
+            }
+        }
+        return table;
+    }
+
+    // Lookup table used instead of the locale-dependent <cctype> functions
+    inline constexpr CharClassTable kCharClasses = make_char_classes();
+
+    inline bool has_class(char c, CharClass char_class) {
+        return (kCharClasses.classes[static_cast<unsigned char>(c)] & char_class) != 0;
+    }
+
+    inline bool is_space(char c) {
+        return has_class(c, kSpace);
+    }
+
+    /**
+     * @brief Check that text is a valid element or attribute name
+     * @param name The name to check
+     * @return True if name is non-empty and made of name characters
+     */
+    inline bool is_name(std::string_view name) {
+        if (name.empty() || !has_class(name.front(), kNameStart)) {
+            return false;
+        }
+        for (char c : name) {
+            if (!has_class(c, kNameChar)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Skip whitespace characters
+     * @param content The XML content
+     * @param pos Current position, moved past the whitespace
+     */
+    inline void skip_whitespace(std::string_view content, size_t& pos) {
+        while (pos < content.size() && is_space(content[pos])) {
+            pos++;
+        }
+    }
+
+    /**
+     * @brief Strip leading and trailing whitespace without copying
+     * @param text The text to trim
+     * @return View of the trimmed text
+     */
+    inline std::string_view trim(std::string_view text) {
+        size_t start = 0;
+        size_t end = text.size();
+        while (start < end && is_space(text[start])) {
+            start++;
+        }
+        while (end > start && is_space(text[end - 1])) {
+            end--;
+        }
+        return text.substr(start, end - start);
+    }
+
+    /**
+     * @brief Scan an element name
+     *
+     * The name ends at whitespace, '>' or '/'.
+     *
+     * @param content The XML content
+     * @param pos Position of the name, moved past it
+     * @return The name, empty if there is none
+     */
+    std::string_view scan_element_name(std::string_view content, size_t& pos);
+
+    /**
+     * @brief Scan one attribute of the form name="value"
+     *
+     * The value is returned as written, without decoding entities.
+     *
+     * @param content The XML content
+     * @param pos Position of the attribute name, moved past the closing quote
+     * @param name Receives the attribute name
+     * @param raw_value Receives the attribute value between the quotes
+     * @return nullptr if successful, otherwise an error message
+     */
+    const char* scan_attribute(std::string_view content, size_t& pos, std::string_view& name, std::string_view& raw_value);
+
+    /**
+     * @brief Find the '>' that ends a tag, skipping quoted attribute values
+     *
+     * The quote state is passed in and out, so a scan over input that
+     * arrives in pieces can resume where it stopped.
+     *
+     * @param content The XML content
+     * @param pos Position to start scanning at
+     * @param quote Quote character of an open attribute value, or 0
+     * @return Position of the '>', or npos if the tag is incomplete
+     */
+    size_t find_tag_end(std::string_view content, size_t pos, char& quote);
+
+    /**
+     * @brief Find the '>' that ends a document type declaration
+     *
+     * Quoted literals and the internal subset in [...] are skipped,
+     * including comments and processing instructions inside it. When the
+     * declaration is incomplete, pos and in_subset are left where a scan
+     * over more of the input should resume.
+     *
+     * @param content The XML content
+     * @param pos Position to start scanning at, moved to the resume point
+     * @param in_subset Whether the scan is inside the internal subset
+     * @return Position of the '>', or npos if the declaration is incomplete
+     */
+    size_t find_doctype_end(std::string_view content, size_t& pos, bool& in_subset);
+
+    /**
+     * @brief Decode the text that runs up to the next '<'
+     *
+     * One vectorized search finds both '<' and '&'; runs without any
+     * entity references are appended without a second pass.
+     *
+     * @param content The XML content
+     * @param pos Start of the text
+     * @param out Output buffer the decoded text is appended to
+     * @return Position of the next '<', or the content size if there is none
+     */
+    size_t scan_text(std::string_view content, size_t pos, std::string& out);
+    size_t scan_text(std::string_view content, size_t pos, std::pmr::string& out);
+
+    /**
+     * @brief Decode XML entity references in a single forward pass
+     *
+     * Handles the five predefined entities and numeric character
+     * references (&#NNN; and &#xHH;), which are written as UTF-8.
+     * Unknown or malformed references are copied through unchanged.
+     *
+     * @param text The raw text
+     * @param out Output buffer the decoded text is appended to
+     */
+    void decode_entities(std::string_view text, std::string& out);
+    void decode_entities(std::string_view text, std::pmr::string& out);
+
+    /**
+     * @brief Escape text content in a single pass
+     *
+     * Replaces '&', '<' and '>' with entity references.
+     *
+     * @param text The text to escape
+     * @param out Output buffer the escaped text is appended to
+     */
+    void escape_text(std::string_view text, std::string& out);
+
+    /**
+     * @brief Escape a double-quoted attribute value in a single pass
+     *
+     * Replaces '&', '<', '>' and '"' with entity references.
+     *
+     * @param text The attribute value to escape
+     * @param out Output buffer the escaped value is appended to
+     */
+    void escape_attribute(std::string_view text, std::string& out);
+
+} // namespace detail
+} // namespace parser
@@ -0,0 +1,203 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <ostream>
+#include "parsers/xml_parser.h"
+
+namespace parser {
+
+    /**
+     * @brief Streaming XML writer
+     *
+     * Output is appended to one buffer as it is produced, so writing a
+     * document takes time linear in its size. When writing to a file, a
+     * file descriptor or an output stream the buffer is drained every
+     * kFlushSize bytes, and memory use does not grow with the document.
+     * Without an open call the writer fills an internal buffer read with
+     * str().
+     *
+     * Documents are written either with the push API (start_element,
+     * attribute, text, end_element, ...) or from an XMLNode tree with
+     * write_node(). Elements without content are written self-closing.
+     *
+     * With an indent set, every element starts on its own line. Once an
+     * element contains text its content is written as is, since added
+     * whitespace would change it.
+     */
+    class XMLWriter {
+    public:
+        static constexpr size_t kFlushSize = 64 * 1024;
+
+        XMLWriter() = default;
+        ~XMLWriter();
+
+        XMLWriter(const XMLWriter&) = delete;
+        XMLWriter& operator=(const XMLWriter&) = delete;
+
+        /**
+         * @brief Write to a file, replacing its contents
+         * @param filename The output file path
+         * @return True if the file could be created
+         */
+        bool open(const std::string& filename);
+
+        /**
+         * @brief Append to a string owned by the caller
+         * @param out The output string, which must outlive the writer
+         */
+        void open_buffer(std::string& out);
+
+        /**
+         * @brief Write to an output stream
+         * @param stream The output stream, which must outlive the writer
+         */
+        void open_stream(std::ostream& stream);
+
+        /**
+         * @brief Write to a file descriptor owned by the caller
+         * @param fd The file descriptor
+         */
+        void open_fd(int fd);
+
+        /**
+         * @brief Set the indentation
+         * @param spaces Spaces per nesting level; 0 writes everything on one line
+         */
+        void set_indent(int spaces) { indent_ = spaces > 0 ? spaces : 0; }
+
+        /**
+         * @brief Write the <?xml version="1.0" encoding="UTF-8"?> declaration
+         */
+        void declaration();
+
+        /**
+         * @brief Open an element
+         * @param name The element name
+         */
+        void start_element(std::string_view name);
+
+        /**
+         * @brief Add an attribute to the element just opened
+         * @param name The attribute name
+         * @param value The attribute value, escaped on output
+         */
+        void attribute(std::string_view name, std::string_view value);
+
+        /**
+         * @brief Write text content
+         * @param text The text, escaped on output
+         */
+        void text(std::string_view text);
+
+        /**
+         * @brief Write markup as is, without escaping
+         * @param markup Well-formed XML text
+         */
+        void raw(std::string_view markup);
+
+        /**
+         * @brief Write a CDATA section
+         * @param data The section content; must not contain "]]>"
+         */
+        void cdata(std::string_view data);
+
+        /**
+         * @brief Write a comment
+         * @param data The comment text; must not contain "--"
+         */
+        void comment(std::string_view data);
+
+        /**
+         * @brief Write a processing instruction
+         * @param target The target name
+         * @param data The instruction data, may be empty
+         */
+        void processing_instruction(std::string_view target, std::string_view data = std::string_view());
+
+        /**
+         * @brief Close the innermost open element
+         */
+        void end_element();
+
+        /**
+         * @brief Write a node and its subtree
+         *
+         * Content nodes of a document parsed with preserve_content are
+         * written as they were read.
+         *
+         * @param node The node to write
+         */
+        void write_node(const XMLNode& node);
+
+        /**
+         * @brief Hand buffered output to the file, descriptor or stream
+         * @return False if writing failed
+         */
+        bool flush();
+
+        /**
+         * @brief Flush and close a file opened with open()
+         * @return False if writing failed
+         */
+        bool close();
+
+        /**
+         * @brief Check that no write or usage error occurred
+         * @return True if all output so far was written
+         */
+        bool good() const { return error_.empty(); }
+
+        /**
+         * @brief Get the first error
+         * @return The error message, empty if there was none
+         */
+        const std::string& error_message() const { return error_; }
+
+        /**
+         * @brief Get the number of open elements
+         * @return Nesting depth
+         */
+        size_t depth() const { return open_.size(); }
+
+        /**
+         * @brief Get the internal buffer
+         * @return Output written so far when no sink was opened
+         */
+        const std::string& str() const { return buffer_; }
+
+    private:
+        struct OpenElement {
+            size_t name_end;      // End of the name in open_names_
+            bool has_children;    // Markup was written inside the element
+            bool inline_content;  // No indentation inside the element
+        };
+
+        enum class Sink { Buffer, Stream, File };
+
+        void reset();
+        void fail(const char* message);
+        void close_start_tag();
+        void begin_child(bool is_text);
+        void write_content(const XMLNode& node);
+        void maybe_flush();
+
+        Sink sink_ = Sink::Buffer;
+        std::string buffer_;
+        std::string* out_ = &buffer_;
+        std::ostream* stream_ = nullptr;
+        int fd_ = -1;
+        bool owns_fd_ = false;
+
+        int indent_ = 0;
+        bool start_tag_open_ = false;
+        bool written_ = false; // Anything was written at the top level
+        std::string error_;
+
+        // Names of the open elements, stored back to back
+        std::string open_names_;
+        std::vector<OpenElement> open_;
+    };
+
+} // namespace parser
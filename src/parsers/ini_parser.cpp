@@ -3,6 +3,9 @@
 #include <sstream>
 #include <algorithm>
 #include <cctype>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
 
 namespace parser {
 
@@ -27,11 +30,14 @@ namespace parser {
             return default_value;
         }
         
-        try {
-            return std::stoi(value);
-        } catch (const std::exception&) {
+        const char* begin = value.c_str();
+        char* end = nullptr;
+        errno = 0;
+        long parsed = std::strtol(begin, &end, 10);
+        if (end == begin || errno == ERANGE || parsed < INT_MIN || parsed > INT_MAX) {
             return default_value;
         }
+        return static_cast<int>(parsed);
     }
 
     bool INIResult::get_bool(const std::string& section_name, const std::string& key, bool default_value) const {
@@ -52,11 +58,14 @@ namespace parser {
             return default_value;
         }
         
-        try {
-            return std::stod(value);
-        } catch (const std::exception&) {
+        const char* begin = value.c_str();
+        char* end = nullptr;
+        errno = 0;
+        double parsed = std::strtod(begin, &end);
+        if (end == begin || errno == ERANGE) {
             return default_value;
         }
+        return parsed;
     }
 
     bool INIResult::has_section(const std::string& section_name) const {
@@ -97,33 +106,47 @@ namespace parser {
         std::istringstream stream(content);
         std::string line;
         std::string current_section = "";
+        size_t line_number = 0;
+        size_t next_line_offset = 0;
         
         while (std::getline(stream, line)) {
-            line = trim(line);
+            // Only offsets are tracked here; fail() derives the column on error
+            size_t line_offset = next_line_offset;
+            next_line_offset += line.length() + 1;
+            line_number++;
+
+            auto fail = [&](const std::string& message) {
+                size_t indent = line.find_first_not_of(" \t\r\n");
+                if (indent == std::string::npos) {
+                    indent = 0;
+                }
+                result.success = false;
+                result.error_location.offset = line_offset + indent;
+                result.error_location.line = line_number;
+                result.error_location.column = indent + 1;
+                result.error_message = message + trim(line) + " at " + result.error_location.to_string();
+                return result;
+            };
+
+            std::string trimmed = trim(line);
             
-            if (is_empty(line) || is_comment(line)) {
+            if (is_empty(trimmed) || is_comment(trimmed)) {
                 continue;
             }
             
-            if (is_section(line)) {
-                current_section = extract_section(line);
+            if (is_section(trimmed)) {
+                current_section = extract_section(trimmed);
                 if (current_section.empty()) {
-                    result.success = false;
-                    result.error_message = "Invalid section format: " + line;
-                    return result;
+                    return fail("Invalid section format: ");
                 }
             } else {
                 if (current_section.empty()) {
-                    result.success = false;
-                    result.error_message = "Key-value pair found outside of section: " + line;
-                    return result;
+                    return fail("Key-value pair found outside of section: ");
                 }
                 
-                auto key_value = parse_key_value(line);
+                auto key_value = parse_key_value(trimmed);
                 if (key_value.first.empty()) {
-                    result.success = false;
-                    result.error_message = "Invalid key-value format: " + line;
-                    return result;
+                    return fail("Invalid key-value format: ");
                 }
                 
                 result.sections[current_section][key_value.first] = key_value.second;
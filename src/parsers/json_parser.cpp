@@ -3,9 +3,231 @@
 #include <sstream>
 #include <algorithm>
 #include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <thread>
 
 namespace parser {
 
+    namespace {
+
+        // CBOR major types (RFC 8949, section 3.1)
+        constexpr uint8_t kCborUnsigned = 0;
+        constexpr uint8_t kCborNegative = 1;
+        constexpr uint8_t kCborBytes = 2;
+        constexpr uint8_t kCborText = 3;
+        constexpr uint8_t kCborArray = 4;
+        constexpr uint8_t kCborMap = 5;
+        constexpr uint8_t kCborTag = 6;
+        constexpr uint8_t kCborSimple = 7;
+
+        constexpr uint8_t kCborIndefinite = 31;
+        constexpr uint8_t kCborBreak = 0xff;
+        constexpr int kCborMaxDepth = 512;
+
+        void write_cbor_head(std::string& out, uint8_t major, uint64_t argument) {
+            uint8_t initial = static_cast<uint8_t>(major << 5);
+            if (argument < 24) {
+                out += static_cast<char>(initial | argument);
+                return;
+            }
+
+            int bytes;
+            if (argument <= 0xff) {
+                out += static_cast<char>(initial | 24);
+                bytes = 1;
+            } else if (argument <= 0xffff) {
+                out += static_cast<char>(initial | 25);
+                bytes = 2;
+            } else if (argument <= 0xffffffffULL) {
+                out += static_cast<char>(initial | 26);
+                bytes = 4;
+            } else {
+                out += static_cast<char>(initial | 27);
+                bytes = 8;
+            }
+
+            for (int i = bytes - 1; i >= 0; --i) {
+                out += static_cast<char>((argument >> (i * 8)) & 0xff);
+            }
+        }
+
+        ParseStatus read_cbor_uint(const std::string& data, size_t& pos, int bytes, uint64_t& value) {
+            if (data.length() - pos < static_cast<size_t>(bytes)) {
+                return ParseStatus{"Unexpected end of CBOR input"};
+            }
+
+            value = 0;
+            for (int i = 0; i < bytes; ++i) {
+                value = (value << 8) | static_cast<uint8_t>(data[pos++]);
+            }
+            return {};
+        }
+
+        ParseStatus read_cbor_argument(const std::string& data, size_t& pos, uint8_t info, uint64_t& value) {
+            if (info < 24) {
+                value = info;
+                return {};
+            }
+            switch (info) {
+                case 24: return read_cbor_uint(data, pos, 1, value);
+                case 25: return read_cbor_uint(data, pos, 2, value);
+                case 26: return read_cbor_uint(data, pos, 4, value);
+                case 27: return read_cbor_uint(data, pos, 8, value);
+                default:
+                    return ParseStatus{"Invalid CBOR additional information: " + std::to_string(info)};
+            }
+        }
+
+        double half_to_double(uint16_t half) {
+            int exponent = (half >> 10) & 0x1f;
+            int mantissa = half & 0x3ff;
+            double value;
+            if (exponent == 0) {
+                value = std::ldexp(mantissa, -24);
+            } else if (exponent != 31) {
+                value = std::ldexp(mantissa + 1024, exponent - 25);
+            } else {
+                value = mantissa == 0 ? INFINITY : NAN;
+            }
+            return (half & 0x8000) ? -value : value;
+        }
+
+        // Smallest chunk worth handing to its own thread
+        constexpr size_t kParallelMinChunk = 64 * 1024;
+
+        /**
+         * Structural pre-scan of the top-level container starting at open.
+         * Fills splits with the delimiter positions that bound each chunk:
+         * the opening bracket, top-level commas near every chunk_size bytes,
+         * and the closing bracket. Returns false on malformed structure.
+         */
+        bool find_split_points(const std::string& content, size_t open, size_t chunk_size, std::vector<size_t>& splits) {
+            const char* data = content.data();
+            size_t length = content.length();
+            size_t depth = 0;
+            size_t next_split = open + chunk_size;
+
+            for (size_t pos = open; pos < length; ++pos) {
+                switch (data[pos]) {
+                    case '"': {
+                        // Jump to the closing quote, skipping escaped ones
+                        size_t search = pos + 1;
+                        while (true) {
+                            const void* quote = std::memchr(data + search, '"', length - search);
+                            if (!quote) {
+                                return false;
+                            }
+                            size_t quote_pos = static_cast<const char*>(quote) - data;
+                            size_t backslashes = 0;
+                            while (quote_pos - backslashes > pos + 1 && data[quote_pos - backslashes - 1] == '\\') {
+                                backslashes++;
+                            }
+                            if (backslashes % 2 == 0) {
+                                pos = quote_pos;
+                                break;
+                            }
+                            search = quote_pos + 1;
+                        }
+                        break;
+                    }
+                    case '[':
+                    case '{':
+                        if (depth++ == 0) {
+                            splits.push_back(pos);
+                        }
+                        break;
+                    case ']':
+                    case '}':
+                        if (depth == 0) {
+                            return false;
+                        }
+                        if (--depth == 0) {
+                            char expected = data[open] == '[' ? ']' : '}';
+                            if (data[pos] != expected) {
+                                return false;
+                            }
+                            splits.push_back(pos);
+                            return true;
+                        }
+                        break;
+                    case ',':
+                        if (depth == 1 && pos >= next_split) {
+                            splits.push_back(pos);
+                            next_split = pos + chunk_size;
+                        }
+                        break;
+                    default:
+                        break;
+                }
+            }
+            return false;
+        }
+
+        // Reads a definite or indefinite length text/byte string
+        ParseStatus read_cbor_string(const std::string& data, size_t& pos, uint8_t major, uint8_t info,
+                                     std::string& out) {
+            if (info == kCborIndefinite) {
+                while (true) {
+                    if (pos >= data.length()) {
+                        return ParseStatus{"Unterminated CBOR string"};
+                    }
+                    uint8_t initial = static_cast<uint8_t>(data[pos++]);
+                    if (initial == kCborBreak) {
+                        return {};
+                    }
+                    if ((initial >> 5) != major || (initial & 0x1f) == kCborIndefinite) {
+                        return ParseStatus{"Invalid chunk in CBOR string"};
+                    }
+                    if (ParseStatus status = read_cbor_string(data, pos, major, initial & 0x1f, out); !status) {
+                        return status;
+                    }
+                }
+            }
+
+            uint64_t length;
+            if (ParseStatus status = read_cbor_argument(data, pos, info, length); !status) {
+                return status;
+            }
+            if (length > data.length() - pos) {
+                return ParseStatus{"CBOR string length exceeds input"};
+            }
+            out.append(data, pos, static_cast<size_t>(length));
+            pos += static_cast<size_t>(length);
+            return {};
+        }
+
+        // Non-throwing replacements for std::stoi/std::stod
+        bool to_int(const std::string& str, int& value) {
+            const char* begin = str.c_str();
+            char* end = nullptr;
+            errno = 0;
+            long parsed = std::strtol(begin, &end, 10);
+            if (end == begin || errno == ERANGE || parsed < INT_MIN || parsed > INT_MAX) {
+                return false;
+            }
+            value = static_cast<int>(parsed);
+            return true;
+        }
+
+        bool to_double(const std::string& str, double& value) {
+            const char* begin = str.c_str();
+            char* end = nullptr;
+            errno = 0;
+            double parsed = std::strtod(begin, &end);
+            if (end == begin || errno == ERANGE) {
+                return false;
+            }
+            value = parsed;
+            return true;
+        }
+
+    } // namespace
+
     // JSONValue implementation
     std::string JSONValue::as_string() const {
         switch (type_) {
@@ -27,7 +249,10 @@ namespace parser {
     int JSONValue::as_int() const {
         switch (type_) {
             case Type::String:
-                try { return std::stoi(string_value_); } catch (...) { return 0; }
+                {
+                    int value = 0;
+                    return to_int(string_value_, value) ? value : 0;
+                }
             case Type::Integer:
                 return int_value_;
             case Type::Number:
@@ -42,7 +267,10 @@ namespace parser {
     double JSONValue::as_double() const {
         switch (type_) {
             case Type::String:
-                try { return std::stod(string_value_); } catch (...) { return 0.0; }
+                {
+                    double value = 0.0;
+                    return to_double(string_value_, value) ? value : 0.0;
+                }
             case Type::Integer:
                 return static_cast<double>(int_value_);
             case Type::Number:
@@ -69,7 +297,19 @@ namespace parser {
         }
     }
 
+    JSONValue JSONValue::make(Type type) {
+        JSONValue value;
+        if (type == Type::Object || type == Type::Array) {
+            value.type_ = type;
+        }
+        return value;
+    }
+
     void JSONValue::set(const std::string& key, const JSONValue& value) {
+        set(key, JSONValue(value));
+    }
+
+    void JSONValue::set(const std::string& key, JSONValue&& value) {
         if (type_ != Type::Object) {
             type_ = Type::Object;
             string_value_.clear();
@@ -78,7 +318,7 @@ namespace parser {
             bool_value_ = false;
             array_values_.clear();
         }
-        object_values_[key] = value;
+        object_values_[key] = std::move(value);
     }
 
     JSONValue JSONValue::get(const std::string& key) const {
@@ -111,6 +351,10 @@ namespace parser {
     }
 
     void JSONValue::push_back(const JSONValue& value) {
+        push_back(JSONValue(value));
+    }
+
+    void JSONValue::push_back(JSONValue&& value) {
         if (type_ != Type::Array) {
             type_ = Type::Array;
             string_value_.clear();
@@ -119,7 +363,7 @@ namespace parser {
             bool_value_ = false;
             object_values_.clear();
         }
-        array_values_.push_back(value);
+        array_values_.push_back(std::move(value));
     }
 
     JSONValue JSONValue::at(size_t index) const {
@@ -212,13 +456,14 @@ namespace parser {
         JSONResult result;
         size_t pos = 0;
         
-        try {
-            skip_whitespace(content, pos);
-            result.root = parse_value(content, pos);
+        skip_whitespace(content, pos);
+        ParseStatus status = parse_value(content, pos, result.root);
+        if (status) {
             result.success = true;
-        } catch (const std::exception& e) {
+        } else {
             result.success = false;
-            result.error_message = e.what();
+            result.error_location = ErrorLocation::from_offset(content, pos);
+            result.error_message = status.message + " at " + result.error_location.to_string();
         }
         
         return result;
@@ -238,6 +483,90 @@ namespace parser {
         return parse(buffer.str());
     }
 
+    JSONResult JSONParser::parse_parallel(const std::string& content, size_t thread_count) {
+        if (thread_count == 0) {
+            thread_count = std::max<size_t>(1, std::thread::hardware_concurrency());
+        }
+        thread_count = std::min(thread_count, content.length() / kParallelMinChunk);
+
+        size_t open = 0;
+        skip_whitespace(content, open);
+        if (thread_count <= 1 || open >= content.length() || (content[open] != '[' && content[open] != '{')) {
+            return parse(content);
+        }
+
+        std::vector<size_t> splits;
+        size_t chunk_size = (content.length() - open) / thread_count + 1;
+        if (!find_split_points(content, open, chunk_size, splits) || splits.size() < 3) {
+            // Malformed or a single chunk: the sequential parser reports errors precisely
+            return parse(content);
+        }
+
+        struct Chunk {
+            std::vector<std::string> keys;
+            std::vector<JSONValue> values;
+            std::string error_message;
+            size_t error_pos = 0;
+            bool failed = false;
+        };
+
+        bool is_object = content[open] == '{';
+        size_t chunk_count = splits.size() - 1;
+        std::vector<Chunk> chunks(chunk_count);
+        std::vector<std::thread> workers;
+        workers.reserve(chunk_count - 1);
+
+        auto work = [&](size_t index) {
+            Chunk& chunk = chunks[index];
+            size_t pos = splits[index];
+            ParseStatus status = parse_chunk(content, pos, splits[index + 1], is_object ? &chunk.keys : nullptr, chunk.values);
+            if (!status) {
+                chunk.failed = true;
+                chunk.error_message = std::move(status.message);
+                chunk.error_pos = pos;
+            }
+        };
+
+        for (size_t i = 1; i < chunk_count; ++i) {
+            workers.emplace_back(work, i);
+        }
+        work(0);
+        for (auto& worker : workers) {
+            worker.join();
+        }
+
+        JSONResult result;
+        for (const auto& chunk : chunks) {
+            if (chunk.failed) {
+                result.success = false;
+                result.error_location = ErrorLocation::from_offset(content, chunk.error_pos);
+                result.error_message = chunk.error_message + " at " + result.error_location.to_string();
+                return result;
+            }
+        }
+
+        // Stitch the per-thread values together in document order
+        result.root = JSONValue::make(is_object ? JSONValue::Type::Object : JSONValue::Type::Array);
+        if (!is_object) {
+            size_t total = 0;
+            for (const auto& chunk : chunks) {
+                total += chunk.values.size();
+            }
+            result.root.array_values_.reserve(total);
+        }
+        for (auto& chunk : chunks) {
+            for (size_t i = 0; i < chunk.values.size(); ++i) {
+                if (is_object) {
+                    result.root.object_values_[std::move(chunk.keys[i])] = std::move(chunk.values[i]);
+                } else {
+                    result.root.array_values_.push_back(std::move(chunk.values[i]));
+                }
+            }
+        }
+        result.success = true;
+        return result;
+    }
+
     std::string JSONParser::to_string(const JSONResult& result, bool pretty_print) {
         return value_to_string(result.root, 0, pretty_print);
     }
@@ -252,151 +581,263 @@ namespace parser {
         return true;
     }
 
+    JSONResult JSONParser::parse_cbor(const std::string& data) {
+        JSONResult result;
+        size_t pos = 0;
+
+        ParseStatus status;
+        if (data.empty()) {
+            status = fail("Empty CBOR input");
+        } else if ((status = parse_cbor_value(data, pos, result.root))) {
+            if (pos == data.length()) {
+                result.success = true;
+            } else {
+                status = fail("Trailing data after CBOR item");
+            }
+        }
+
+        if (!result.success) {
+            result.error_location.offset = pos;
+            result.error_message = status.message + " at " + result.error_location.to_string();
+        }
+
+        return result;
+    }
+
+    JSONResult JSONParser::parse_cbor_file(const std::string& filename) {
+        std::ifstream file(filename, std::ios::binary);
+        if (!file.is_open()) {
+            JSONResult result;
+            result.success = false;
+            result.error_message = "Cannot open file: " + filename;
+            return result;
+        }
+
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        return parse_cbor(buffer.str());
+    }
+
+    std::string JSONParser::to_cbor(const JSONResult& result) {
+        std::string out;
+        value_to_cbor(result.root, out);
+        return out;
+    }
+
+    bool JSONParser::save_to_cbor_file(const JSONResult& result, const std::string& filename) {
+        std::ofstream file(filename, std::ios::binary);
+        if (!file.is_open()) {
+            return false;
+        }
+
+        std::string data = to_cbor(result);
+        file.write(data.data(), static_cast<std::streamsize>(data.size()));
+        return static_cast<bool>(file);
+    }
+
     // Private helper methods
-    JSONValue JSONParser::parse_value(const std::string& content, size_t& pos) {
+    ParseStatus JSONParser::fail(const std::string& message) {
+        return ParseStatus{message};
+    }
+
+    ParseStatus JSONParser::parse_value(const std::string& content, size_t& pos, JSONValue& value) {
         skip_whitespace(content, pos);
         
         if (pos >= content.length()) {
-            throw std::runtime_error("Unexpected end of input");
+            return fail("Unexpected end of input");
         }
         
         char c = content[pos];
         
         if (c == '{') {
-            return parse_object(content, pos);
+            return parse_object(content, pos, value);
         } else if (c == '[') {
-            return parse_array(content, pos);
+            return parse_array(content, pos, value);
         } else if (c == '"') {
-            return JSONValue(parse_string(content, pos));
+            value = JSONValue(std::string{});
+            return parse_string(content, pos, value.string_value_);
         } else if (c == 't' || c == 'f') {
             // Boolean
-            if (content.substr(pos, 4) == "true") {
+            if (content.compare(pos, 4, "true") == 0) {
                 pos += 4;
-                return JSONValue(true);
-            } else if (content.substr(pos, 5) == "false") {
+                value = JSONValue(true);
+                return {};
+            } else if (content.compare(pos, 5, "false") == 0) {
                 pos += 5;
-                return JSONValue(false);
+                value = JSONValue(false);
+                return {};
             } else {
-                throw std::runtime_error("Invalid boolean value");
+                return fail("Invalid boolean value");
             }
         } else if (c == 'n') {
             // Null
-            if (content.substr(pos, 4) == "null") {
+            if (content.compare(pos, 4, "null") == 0) {
                 pos += 4;
-                return JSONValue();
+                value = JSONValue();
+                return {};
             } else {
-                throw std::runtime_error("Invalid null value");
+                return fail("Invalid null value");
             }
-        } else if (std::isdigit(c) || c == '-') {
-            return parse_number(content, pos);
+        } else if (std::isdigit(static_cast<unsigned char>(c)) || c == '-') {
+            return parse_number(content, pos, value);
         } else {
-            throw std::runtime_error("Unexpected character: " + std::string(1, c));
+            return fail("Unexpected character: " + std::string(1, c));
         }
     }
 
-    JSONValue JSONParser::parse_object(const std::string& content, size_t& pos) {
-        JSONValue obj;
-        obj.set("", JSONValue()); // Initialize as object
+    ParseStatus JSONParser::parse_object(const std::string& content, size_t& pos, JSONValue& obj) {
+        obj = JSONValue::make(JSONValue::Type::Object);
         
         pos++; // Skip '{'
         skip_whitespace(content, pos);
         
         if (pos < content.length() && content[pos] == '}') {
             pos++; // Skip '}'
-            return obj;
+            return {};
         }
         
+        std::string key;
         while (pos < content.length()) {
             skip_whitespace(content, pos);
             
-            if (content[pos] != '"') {
-                throw std::runtime_error("Expected string key in object");
+            if (pos >= content.length() || content[pos] != '"') {
+                return fail("Expected string key in object");
             }
             
-            std::string key = parse_string(content, pos);
+            key.clear();
+            if (ParseStatus status = parse_string(content, pos, key); !status) {
+                return status;
+            }
             skip_whitespace(content, pos);
             
             if (pos >= content.length() || content[pos] != ':') {
-                throw std::runtime_error("Expected ':' after key");
+                return fail("Expected ':' after key");
             }
             
             pos++; // Skip ':'
             skip_whitespace(content, pos);
             
-            JSONValue value = parse_value(content, pos);
-            obj.set(key, value);
+            if (ParseStatus status = parse_value(content, pos, obj.object_values_[key]); !status) {
+                return status;
+            }
             
             skip_whitespace(content, pos);
             
             if (pos >= content.length()) {
-                throw std::runtime_error("Unexpected end of input in object");
+                return fail("Unexpected end of input in object");
             }
             
             if (content[pos] == '}') {
                 pos++; // Skip '}'
-                break;
+                return {};
             } else if (content[pos] == ',') {
                 pos++; // Skip ','
             } else {
-                throw std::runtime_error("Expected ',' or '}' in object");
+                return fail("Expected ',' or '}' in object");
             }
         }
         
-        return obj;
+        return fail("Unexpected end of input in object");
     }
 
-    JSONValue JSONParser::parse_array(const std::string& content, size_t& pos) {
-        JSONValue arr;
+    ParseStatus JSONParser::parse_array(const std::string& content, size_t& pos, JSONValue& arr) {
+        arr = JSONValue::make(JSONValue::Type::Array);
         
         pos++; // Skip '['
         skip_whitespace(content, pos);
         
         if (pos < content.length() && content[pos] == ']') {
             pos++; // Skip ']'
-            return arr;
+            return {};
         }
         
         while (pos < content.length()) {
             skip_whitespace(content, pos);
             
-            JSONValue value = parse_value(content, pos);
-            arr.push_back(value);
+            arr.array_values_.emplace_back();
+            if (ParseStatus status = parse_value(content, pos, arr.array_values_.back()); !status) {
+                return status;
+            }
             
             skip_whitespace(content, pos);
             
             if (pos >= content.length()) {
-                throw std::runtime_error("Unexpected end of input in array");
+                return fail("Unexpected end of input in array");
             }
             
             if (content[pos] == ']') {
                 pos++; // Skip ']'
-                break;
+                return {};
             } else if (content[pos] == ',') {
                 pos++; // Skip ','
             } else {
-                throw std::runtime_error("Expected ',' or ']' in array");
+                return fail("Expected ',' or ']' in array");
             }
         }
         
-        return arr;
+        return fail("Unexpected end of input in array");
+    }
+
+    ParseStatus JSONParser::parse_chunk(const std::string& content, size_t& pos, size_t end,
+                                        std::vector<std::string>* keys, std::vector<JSONValue>& values) {
+        bool container_start = content[pos] == '[' || content[pos] == '{';
+        pos++; // Skip delimiter
+        skip_whitespace(content, pos);
+
+        if (container_start && pos == end && (content[end] == ']' || content[end] == '}')) {
+            return {}; // Empty container
+        }
+
+        while (true) {
+            skip_whitespace(content, pos);
+
+            if (keys) {
+                if (pos >= end || content[pos] != '"') {
+                    return fail("Expected string key in object");
+                }
+                keys->emplace_back();
+                if (ParseStatus status = parse_string(content, pos, keys->back()); !status) {
+                    return status;
+                }
+                skip_whitespace(content, pos);
+
+                if (pos >= end || content[pos] != ':') {
+                    return fail("Expected ':' after key");
+                }
+                pos++; // Skip ':'
+            }
+
+            values.emplace_back();
+            if (ParseStatus status = parse_value(content, pos, values.back()); !status) {
+                return status;
+            }
+            skip_whitespace(content, pos);
+
+            if (pos == end) {
+                return {};
+            }
+            if (pos > end || content[pos] != ',') {
+                return fail(keys ? "Expected ',' or '}' in object" : "Expected ',' or ']' in array");
+            }
+            pos++; // Skip ','
+        }
     }
 
-    std::string JSONParser::parse_string(const std::string& content, size_t& pos) {
-        if (content[pos] != '"') {
-            throw std::runtime_error("Expected '\"' at start of string");
+    ParseStatus JSONParser::parse_string(const std::string& content, size_t& pos, std::string& result) {
+        if (pos >= content.length() || content[pos] != '"') {
+            return fail("Expected '\"' at start of string");
         }
         
         pos++; // Skip opening quote
-        std::string result;
         
         while (pos < content.length()) {
             char c = content[pos++];
             
             if (c == '"') {
-                return result;
+                return {};
             } else if (c == '\\') {
                 if (pos >= content.length()) {
-                    throw std::runtime_error("Unexpected end of input in string");
+                    return fail("Unexpected end of input in string");
                 }
                 
                 char escape = content[pos++];
@@ -410,57 +851,63 @@ namespace parser {
                     case 'r': result += '\r'; break;
                     case 't': result += '\t'; break;
                     default:
-                        throw std::runtime_error("Invalid escape sequence: \\" + std::string(1, escape));
+                        return fail("Invalid escape sequence: \\" + std::string(1, escape));
                 }
             } else {
                 result += c;
             }
         }
         
-        throw std::runtime_error("Unterminated string");
+        return fail("Unterminated string");
     }
 
-    JSONValue JSONParser::parse_number(const std::string& content, size_t& pos) {
+    ParseStatus JSONParser::parse_number(const std::string& content, size_t& pos, JSONValue& value) {
         size_t start = pos;
+        bool is_integer = true;
         
         if (content[pos] == '-') {
             pos++;
         }
         
-        while (pos < content.length() && std::isdigit(content[pos])) {
+        while (pos < content.length() && std::isdigit(static_cast<unsigned char>(content[pos]))) {
             pos++;
         }
         
         if (pos < content.length() && content[pos] == '.') {
+            is_integer = false;
             pos++;
-            while (pos < content.length() && std::isdigit(content[pos])) {
+            while (pos < content.length() && std::isdigit(static_cast<unsigned char>(content[pos]))) {
                 pos++;
             }
         }
         
         if (pos < content.length() && (content[pos] == 'e' || content[pos] == 'E')) {
+            is_integer = false;
             pos++;
             if (pos < content.length() && (content[pos] == '+' || content[pos] == '-')) {
                 pos++;
             }
-            while (pos < content.length() && std::isdigit(content[pos])) {
+            while (pos < content.length() && std::isdigit(static_cast<unsigned char>(content[pos]))) {
                 pos++;
             }
         }
         
         std::string num_str = content.substr(start, pos - start);
         
-        try {
-            if (num_str.find('.') != std::string::npos || 
-                num_str.find('e') != std::string::npos || 
-                num_str.find('E') != std::string::npos) {
-                return JSONValue(std::stod(num_str));
-            } else {
-                return JSONValue(std::stoi(num_str));
+        if (is_integer) {
+            int number;
+            if (to_int(num_str, number)) {
+                value = JSONValue(number);
+                return {};
+            }
+        } else {
+            double number;
+            if (to_double(num_str, number)) {
+                value = JSONValue(number);
+                return {};
             }
-        } catch (const std::exception&) {
-            throw std::runtime_error("Invalid number: " + num_str);
         }
+        return fail("Invalid number: " + num_str);
     }
 
     void JSONParser::skip_whitespace(const std::string& content, size_t& pos) {
@@ -516,4 +963,203 @@ namespace parser {
         }
     }
 
+    void JSONParser::value_to_cbor(const JSONValue& value, std::string& out) {
+        switch (value.type_) {
+            case JSONValue::Type::String:
+                write_cbor_head(out, kCborText, value.string_value_.size());
+                out += value.string_value_;
+                break;
+            case JSONValue::Type::Integer:
+                if (value.int_value_ >= 0) {
+                    write_cbor_head(out, kCborUnsigned, static_cast<uint64_t>(value.int_value_));
+                } else {
+                    write_cbor_head(out, kCborNegative, static_cast<uint64_t>(-1 - static_cast<int64_t>(value.int_value_)));
+                }
+                break;
+            case JSONValue::Type::Number: {
+                uint64_t bits;
+                std::memcpy(&bits, &value.double_value_, sizeof(bits));
+                out += static_cast<char>(0xfb);
+                for (int i = 7; i >= 0; --i) {
+                    out += static_cast<char>((bits >> (i * 8)) & 0xff);
+                }
+                break;
+            }
+            case JSONValue::Type::Boolean:
+                out += static_cast<char>(value.bool_value_ ? 0xf5 : 0xf4);
+                break;
+            case JSONValue::Type::Null:
+                out += static_cast<char>(0xf6);
+                break;
+            case JSONValue::Type::Object:
+                write_cbor_head(out, kCborMap, value.object_values_.size());
+                for (const auto& pair : value.object_values_) {
+                    write_cbor_head(out, kCborText, pair.first.size());
+                    out += pair.first;
+                    value_to_cbor(pair.second, out);
+                }
+                break;
+            case JSONValue::Type::Array:
+                write_cbor_head(out, kCborArray, value.array_values_.size());
+                for (const auto& item : value.array_values_) {
+                    value_to_cbor(item, out);
+                }
+                break;
+        }
+    }
+
+    ParseStatus JSONParser::parse_cbor_value(const std::string& data, size_t& pos, JSONValue& value, int depth) {
+        if (pos >= data.length()) {
+            return fail("Unexpected end of CBOR input");
+        }
+        if (depth > kCborMaxDepth) {
+            return fail("CBOR nesting too deep");
+        }
+
+        uint8_t initial = static_cast<uint8_t>(data[pos++]);
+        uint8_t major = initial >> 5;
+        uint8_t info = initial & 0x1f;
+        uint64_t argument = 0;
+
+        switch (major) {
+            case kCborUnsigned:
+            case kCborNegative: {
+                if (ParseStatus status = read_cbor_argument(data, pos, info, argument); !status) {
+                    return status;
+                }
+                if (major == kCborUnsigned) {
+                    if (argument <= static_cast<uint64_t>(INT32_MAX)) {
+                        value = JSONValue(static_cast<int>(argument));
+                    } else {
+                        value = JSONValue(static_cast<double>(argument));
+                    }
+                } else if (argument <= static_cast<uint64_t>(INT32_MAX)) {
+                    value = JSONValue(static_cast<int>(-1 - static_cast<int64_t>(argument)));
+                } else {
+                    value = JSONValue(-1.0 - static_cast<double>(argument));
+                }
+                return {};
+            }
+            case kCborBytes:
+            case kCborText:
+                value = JSONValue(std::string{});
+                return read_cbor_string(data, pos, major, info, value.string_value_);
+            case kCborArray: {
+                value = JSONValue::make(JSONValue::Type::Array);
+                auto& items = value.array_values_;
+                if (info == kCborIndefinite) {
+                    while (pos < data.length() && static_cast<uint8_t>(data[pos]) != kCborBreak) {
+                        items.emplace_back();
+                        if (ParseStatus status = parse_cbor_value(data, pos, items.back(), depth + 1); !status) {
+                            return status;
+                        }
+                    }
+                    if (pos >= data.length()) {
+                        return fail("Unterminated CBOR array");
+                    }
+                    pos++; // Skip break
+                    return {};
+                }
+
+                if (ParseStatus status = read_cbor_argument(data, pos, info, argument); !status) {
+                    return status;
+                }
+                if (argument > data.length() - pos) {
+                    return fail("CBOR array length exceeds input");
+                }
+                items.resize(static_cast<size_t>(argument));
+                for (auto& item : items) {
+                    if (ParseStatus status = parse_cbor_value(data, pos, item, depth + 1); !status) {
+                        return status;
+                    }
+                }
+                return {};
+            }
+            case kCborMap: {
+                value = JSONValue::make(JSONValue::Type::Object);
+                bool indefinite = info == kCborIndefinite;
+                if (!indefinite) {
+                    if (ParseStatus status = read_cbor_argument(data, pos, info, argument); !status) {
+                        return status;
+                    }
+                    if (argument > (data.length() - pos) / 2) {
+                        return fail("CBOR map length exceeds input");
+                    }
+                }
+
+                JSONValue key;
+                for (uint64_t i = 0; indefinite || i < argument; ++i) {
+                    if (indefinite) {
+                        if (pos >= data.length()) {
+                            return fail("Unterminated CBOR map");
+                        }
+                        if (static_cast<uint8_t>(data[pos]) == kCborBreak) {
+                            pos++; // Skip break
+                            break;
+                        }
+                    }
+
+                    if (ParseStatus status = parse_cbor_value(data, pos, key, depth + 1); !status) {
+                        return status;
+                    }
+                    if (key.type_ != JSONValue::Type::String) {
+                        return fail("CBOR map key must be a string");
+                    }
+                    if (ParseStatus status = parse_cbor_value(data, pos, value.object_values_[key.string_value_], depth + 1); !status) {
+                        return status;
+                    }
+                }
+                return {};
+            }
+            case kCborTag:
+                if (ParseStatus status = read_cbor_argument(data, pos, info, argument); !status) {
+                    return status;
+                }
+                return parse_cbor_value(data, pos, value, depth + 1);
+            case kCborSimple:
+            default:
+                break;
+        }
+
+        switch (info) {
+            case 20:
+                value = JSONValue(false);
+                return {};
+            case 21:
+                value = JSONValue(true);
+                return {};
+            case 22:
+            case 23:
+                value = JSONValue();
+                return {};
+            case 25:
+                if (ParseStatus status = read_cbor_uint(data, pos, 2, argument); !status) {
+                    return status;
+                }
+                value = JSONValue(half_to_double(static_cast<uint16_t>(argument)));
+                return {};
+            case 26: {
+                if (ParseStatus status = read_cbor_uint(data, pos, 4, argument); !status) {
+                    return status;
+                }
+                uint32_t bits = static_cast<uint32_t>(argument);
+                float number;
+                std::memcpy(&number, &bits, sizeof(number));
+                value = JSONValue(static_cast<double>(number));
+                return {};
+            }
+            case 27: {
+                if (ParseStatus status = read_cbor_uint(data, pos, 8, argument); !status) {
+                    return status;
+                }
+                double number;
+                std::memcpy(&number, &argument, sizeof(number));
+                value = JSONValue(number);
+                return {};
+            }
+            default:
+                return fail("Unsupported CBOR simple value: " + std::to_string(info));
+        }
+    }
+
 } // namespace parser 
\ No newline at end of file
@@ -0,0 +1,500 @@
+#include "parsers/json_reader.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+namespace parser {
+
+    namespace {
+
+        bool is_json_space(char c) {
+            return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+        }
+
+        bool is_digit(char c) {
+            return c >= '0' && c <= '9';
+        }
+
+        bool is_number_char(char c) {
+            return is_digit(c) || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E';
+        }
+
+        // -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?
+        bool is_valid_number(std::string_view text) {
+            size_t i = 0;
+            auto digits = [&]() {
+                size_t start = i;
+                while (i < text.size() && is_digit(text[i])) {
+                    i++;
+                }
+                return i > start;
+            };
+
+            if (i < text.size() && text[i] == '-') {
+                i++;
+            }
+            if (i < text.size() && text[i] == '0') {
+                i++;
+            } else if (!digits()) {
+                return false;
+            }
+            if (i < text.size() && text[i] == '.') {
+                i++;
+                if (!digits()) {
+                    return false;
+                }
+            }
+            if (i < text.size() && (text[i] == 'e' || text[i] == 'E')) {
+                i++;
+                if (i < text.size() && (text[i] == '+' || text[i] == '-')) {
+                    i++;
+                }
+                if (!digits()) {
+                    return false;
+                }
+            }
+            return i == text.size();
+        }
+
+        bool parse_hex4(std::string_view text, size_t pos, uint32_t& value) {
+            if (pos + 4 > text.size()) {
+                return false;
+            }
+            value = 0;
+            for (size_t i = pos; i < pos + 4; ++i) {
+                char c = text[i];
+                value <<= 4;
+                if (is_digit(c)) {
+                    value |= static_cast<uint32_t>(c - '0');
+                } else if (c >= 'a' && c <= 'f') {
+                    value |= static_cast<uint32_t>(c - 'a' + 10);
+                } else if (c >= 'A' && c <= 'F') {
+                    value |= static_cast<uint32_t>(c - 'A' + 10);
+                } else {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        void append_utf8(uint32_t code_point, std::string& out) {
+            if (code_point < 0x80) {
+                out += static_cast<char>(code_point);
+            } else if (code_point < 0x800) {
+                out += static_cast<char>(0xC0 | (code_point >> 6));
+                out += static_cast<char>(0x80 | (code_point & 0x3F));
+            } else if (code_point < 0x10000) {
+                out += static_cast<char>(0xE0 | (code_point >> 12));
+                out += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+                out += static_cast<char>(0x80 | (code_point & 0x3F));
+            } else {
+                out += static_cast<char>(0xF0 | (code_point >> 18));
+                out += static_cast<char>(0x80 | ((code_point >> 12) & 0x3F));
+                out += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+                out += static_cast<char>(0x80 | (code_point & 0x3F));
+            }
+        }
+
+        // Decodes the escape sequences of a string body; false if one is invalid
+        bool decode_string(std::string_view raw, std::string& out) {
+            size_t run_start = 0;
+            size_t i = 0;
+            while (i < raw.size()) {
+                if (raw[i] != '\\') {
+                    i++;
+                    continue;
+                }
+                out.append(raw.data() + run_start, i - run_start);
+                if (i + 1 >= raw.size()) {
+                    return false;
+                }
+                char escape = raw[i + 1];
+                i += 2;
+                switch (escape) {
+                    case '"': out += '"'; break;
+                    case '\\': out += '\\'; break;
+                    case '/': out += '/'; break;
+                    case 'b': out += '\b'; break;
+                    case 'f': out += '\f'; break;
+                    case 'n': out += '\n'; break;
+                    case 'r': out += '\r'; break;
+                    case 't': out += '\t'; break;
+                    case 'u': {
+                        uint32_t code_point;
+                        if (!parse_hex4(raw, i, code_point)) {
+                            return false;
+                        }
+                        i += 4;
+                        if (code_point >= 0xD800 && code_point <= 0xDBFF) {
+                            // High surrogate, must be followed by a low one
+                            uint32_t low;
+                            if (raw.compare(i, 2, "\\u") != 0 || !parse_hex4(raw, i + 2, low) ||
+                                low < 0xDC00 || low > 0xDFFF) {
+                                return false;
+                            }
+                            i += 6;
+                            code_point = 0x10000 + ((code_point - 0xD800) << 10) + (low - 0xDC00);
+                        } else if (code_point >= 0xDC00 && code_point <= 0xDFFF) {
+                            return false;
+                        }
+                        append_utf8(code_point, out);
+                        break;
+                    }
+                    default:
+                        return false;
+                }
+                run_start = i;
+            }
+            out.append(raw.data() + run_start, raw.size() - run_start);
+            return true;
+        }
+
+    } // namespace
+
+    bool JSONReader::open(const std::string& filename) {
+        reset();
+        if (!file_.open(filename)) {
+            event_ = Event::Error;
+            error_message_ = "Cannot open file: " + filename;
+            return false;
+        }
+        data_ = file_.data();
+        size_ = file_.size();
+        return true;
+    }
+
+    void JSONReader::open_buffer(std::string_view content) {
+        reset();
+        data_ = content.data();
+        size_ = content.size();
+    }
+
+    void JSONReader::open_stream(std::istream& stream, size_t chunk_size) {
+        open_source([&stream](char* buffer, size_t size) {
+            stream.read(buffer, static_cast<std::streamsize>(size));
+            return static_cast<size_t>(stream.gcount());
+        }, chunk_size);
+    }
+
+    void JSONReader::open_source(ReadFunction read, size_t chunk_size) {
+        reset();
+        read_ = std::move(read);
+        chunk_size_ = std::max<size_t>(chunk_size, 1);
+        eof_ = false;
+    }
+
+    JSONReader::Event JSONReader::next() {
+        if (event_ == Event::Error) {
+            return event_;
+        }
+        value_ = std::string_view();
+
+        while (true) {
+            if (!skip_whitespace()) {
+                token_offset_ = base_ + pos_;
+                if (expect_ == Expect::Done) {
+                    depth_ = 0;
+                    event_ = Event::EndDocument;
+                    return event_;
+                }
+                bool empty = expect_ == Expect::Value && open_.empty();
+                return fail(empty ? "No JSON value found" : "Unexpected end of input", size_);
+            }
+
+            token_offset_ = base_ + pos_;
+            char c = data_[pos_];
+            switch (expect_) {
+                case Expect::Done:
+                    return fail("Unexpected content after JSON value", pos_);
+                case Expect::Colon:
+                    if (c != ':') {
+                        return fail("Expected ':' after object key", pos_);
+                    }
+                    pos_++;
+                    expect_ = Expect::Value;
+                    continue;
+                case Expect::CommaOrEnd:
+                    if (c == ',') {
+                        pos_++;
+                        expect_ = open_.back() == '{' ? Expect::Key : Expect::Value;
+                        continue;
+                    }
+                    if (c == '}' || c == ']') {
+                        return close_container(c);
+                    }
+                    return fail("Expected ',' or closing bracket", pos_);
+                case Expect::KeyOrEnd:
+                case Expect::Key:
+                    if (c == '}' && expect_ == Expect::KeyOrEnd) {
+                        return close_container(c);
+                    }
+                    if (c != '"') {
+                        return fail("Expected '\"' at start of key", pos_);
+                    }
+                    return read_string(Event::Key);
+                case Expect::ValueOrEnd:
+                case Expect::Value:
+                    if (c == ']' && expect_ == Expect::ValueOrEnd) {
+                        return close_container(c);
+                    }
+                    return read_value();
+            }
+        }
+    }
+
+    JSONReader::Event JSONReader::report_error(const std::string& message) {
+        if (event_ == Event::Error) {
+            return event_;
+        }
+        return fail(message, token_offset_ - base_);
+    }
+
+    // Private helper methods
+    void JSONReader::reset() {
+        file_.close();
+        read_ = nullptr;
+        buffer_.clear();
+        data_ = nullptr;
+        size_ = 0;
+        pos_ = 0;
+        base_ = 0;
+        eof_ = true;
+        discarded_lines_ = 0;
+        discarded_line_start_ = 0;
+
+        event_ = Event::EndDocument;
+        value_ = std::string_view();
+        decoded_.clear();
+        depth_ = 0;
+        token_offset_ = 0;
+
+        open_.clear();
+        expect_ = Expect::Value;
+
+        error_message_.clear();
+        error_location_ = ErrorLocation();
+    }
+
+    JSONReader::Event JSONReader::fail(const std::string& message, size_t at) {
+        at = std::min(at, size_);
+
+        // Lines before the window were counted when it was discarded
+        size_t line = discarded_lines_ + 1;
+        size_t line_start = discarded_line_start_;
+        const char* end = data_ + at;
+        const char* cursor = data_;
+        while (cursor < end) {
+            const void* newline = std::memchr(cursor, '\n', end - cursor);
+            if (!newline) {
+                break;
+            }
+            cursor = static_cast<const char*>(newline) + 1;
+            line_start = base_ + static_cast<size_t>(cursor - data_);
+            line++;
+        }
+
+        error_location_.offset = base_ + at;
+        error_location_.line = line;
+        error_location_.column = error_location_.offset - line_start + 1;
+        error_message_ = message + " at " + error_location_.to_string();
+
+        value_ = std::string_view();
+        event_ = Event::Error;
+        return event_;
+    }
+
+    bool JSONReader::fill() {
+        if (eof_) {
+            return false;
+        }
+
+        // Drop the input in front of the current token
+        if (pos_ > 0) {
+            const char* begin = buffer_.data();
+            const char* end = begin + pos_;
+            const char* cursor = begin;
+            while (const void* newline = std::memchr(cursor, '\n', end - cursor)) {
+                cursor = static_cast<const char*>(newline) + 1;
+                discarded_line_start_ = base_ + static_cast<size_t>(cursor - begin);
+                discarded_lines_++;
+            }
+            buffer_.erase(0, pos_);
+            base_ += pos_;
+            pos_ = 0;
+        }
+
+        size_t old_size = buffer_.size();
+        buffer_.resize(old_size + chunk_size_);
+        size_t count = std::min(read_(&buffer_[old_size], chunk_size_), chunk_size_);
+        buffer_.resize(old_size + count);
+        data_ = buffer_.data();
+        size_ = buffer_.size();
+
+        if (count == 0) {
+            eof_ = true;
+            return false;
+        }
+        return true;
+    }
+
+    bool JSONReader::ensure(size_t count) {
+        while (size_ - pos_ < count) {
+            if (!fill()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool JSONReader::skip_whitespace() {
+        while (true) {
+            while (pos_ < size_ && is_json_space(data_[pos_])) {
+                pos_++;
+            }
+            if (pos_ < size_) {
+                return true;
+            }
+            if (!fill()) {
+                return false;
+            }
+        }
+    }
+
+    JSONReader::Event JSONReader::read_value() {
+        char c = data_[pos_];
+        switch (c) {
+            case '{':
+            case '[':
+                open_.push_back(c);
+                pos_++;
+                depth_ = open_.size();
+                expect_ = c == '{' ? Expect::KeyOrEnd : Expect::ValueOrEnd;
+                event_ = c == '{' ? Event::StartObject : Event::StartArray;
+                return event_;
+            case '"':
+                return read_string(Event::String);
+            case 't':
+                return read_literal("true", Event::Boolean);
+            case 'f':
+                return read_literal("false", Event::Boolean);
+            case 'n':
+                return read_literal("null", Event::Null);
+            default:
+                if (c == '-' || is_digit(c)) {
+                    return read_number();
+                }
+                return fail("Unexpected character", pos_);
+        }
+    }
+
+    JSONReader::Event JSONReader::read_string(Event event) {
+        // Locate the closing quote first, so the whole string is in the window
+        size_t end;
+        size_t scan = 1;
+        bool escaped = false;
+        while (true) {
+            std::string_view current = window();
+            size_t i = scan;
+            for (; i < current.size(); ++i) {
+                char c = current[i];
+                if (c == '"' || static_cast<unsigned char>(c) < 0x20) {
+                    break;
+                }
+                if (c == '\\') {
+                    if (i + 1 >= current.size()) {
+                        break;
+                    }
+                    escaped = true;
+                    i++;
+                }
+            }
+            if (i < current.size() && current[i] == '"') {
+                end = i;
+                break;
+            }
+            if (i < current.size() && current[i] != '\\') {
+                return fail("Control character in string", pos_ + i);
+            }
+            scan = i;
+            if (!fill()) {
+                return fail("Unterminated string", size_);
+            }
+        }
+
+        std::string_view raw = window().substr(1, end - 1);
+        if (escaped) {
+            decoded_.clear();
+            if (!decode_string(raw, decoded_)) {
+                return fail("Invalid escape sequence", pos_);
+            }
+            value_ = decoded_;
+        } else {
+            value_ = raw;
+        }
+
+        pos_ += end + 1;
+        depth_ = open_.size();
+        if (event == Event::Key) {
+            expect_ = Expect::Colon;
+        } else {
+            value_done();
+        }
+        event_ = event;
+        return event_;
+    }
+
+    JSONReader::Event JSONReader::read_number() {
+        size_t length = 0;
+        while (true) {
+            std::string_view current = window();
+            while (length < current.size() && is_number_char(current[length])) {
+                length++;
+            }
+            // A number ending at the window end may continue in the next chunk
+            if (length < current.size() || !fill()) {
+                break;
+            }
+        }
+
+        std::string_view text = window().substr(0, length);
+        if (!is_valid_number(text)) {
+            return fail("Invalid number", pos_);
+        }
+        value_ = text;
+        pos_ += length;
+        depth_ = open_.size();
+        value_done();
+        event_ = Event::Number;
+        return event_;
+    }
+
+    JSONReader::Event JSONReader::read_literal(std::string_view literal, Event event) {
+        if (!ensure(literal.size()) || window().compare(0, literal.size(), literal) != 0) {
+            return fail("Invalid literal", pos_);
+        }
+        value_ = window().substr(0, literal.size());
+        pos_ += literal.size();
+        depth_ = open_.size();
+        value_done();
+        event_ = event;
+        return event_;
+    }
+
+    JSONReader::Event JSONReader::close_container(char bracket) {
+        char expected = open_.back() == '{' ? '}' : ']';
+        if (bracket != expected) {
+            return fail("Mismatched closing bracket", pos_);
+        }
+        depth_ = open_.size();
+        open_.pop_back();
+        pos_++;
+        value_done();
+        event_ = bracket == '}' ? Event::EndObject : Event::EndArray;
+        return event_;
+    }
+
+    void JSONReader::value_done() {
+        expect_ = open_.empty() ? Expect::Done : Expect::CommaOrEnd;
+    }
+
+} // namespace parser
@@ -0,0 +1,333 @@
+#include "parsers/json_writer.h"
+#include <algorithm>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace parser {
+
+    namespace {
+
+        bool needs_escape(char c) {
+            return c == '"' || c == '\\' || static_cast<unsigned char>(c) < 0x20;
+        }
+
+        // Copies runs that need no escaping in one append
+        void append_escaped(std::string_view text, std::string& out) {
+            static const char kHex[] = "0123456789abcdef";
+            out += '"';
+            size_t run_start = 0;
+            for (size_t i = 0; i < text.size(); ++i) {
+                char c = text[i];
+                if (!needs_escape(c)) {
+                    continue;
+                }
+                out.append(text.data() + run_start, i - run_start);
+                run_start = i + 1;
+                switch (c) {
+                    case '"': out += "\\\""; break;
+                    case '\\': out += "\\\\"; break;
+                    case '\b': out += "\\b"; break;
+                    case '\f': out += "\\f"; break;
+                    case '\n': out += "\\n"; break;
+                    case '\r': out += "\\r"; break;
+                    case '\t': out += "\\t"; break;
+                    default:
+                        out += "\\u00";
+                        out += kHex[(static_cast<unsigned char>(c) >> 4) & 0xf];
+                        out += kHex[static_cast<unsigned char>(c) & 0xf];
+                        break;
+                }
+            }
+            out.append(text.data() + run_start, text.size() - run_start);
+            out += '"';
+        }
+
+    } // namespace
+
+    JSONWriter::~JSONWriter() {
+        close();
+    }
+
+    bool JSONWriter::open(const std::string& filename) {
+        reset();
+#ifdef _WIN32
+        int fd = _open(filename.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+        int fd = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+#endif
+        if (fd < 0) {
+            return false;
+        }
+        sink_ = Sink::File;
+        fd_ = fd;
+        owns_fd_ = true;
+        return true;
+    }
+
+    void JSONWriter::open_buffer(std::string& out) {
+        reset();
+        out_ = &out;
+    }
+
+    void JSONWriter::open_stream(std::ostream& stream) {
+        reset();
+        sink_ = Sink::Stream;
+        stream_ = &stream;
+    }
+
+    void JSONWriter::open_fd(int fd) {
+        reset();
+        sink_ = Sink::File;
+        fd_ = fd;
+    }
+
+    void JSONWriter::start_object() {
+        begin_value();
+        *out_ += '{';
+        open_.push_back(OpenContainer{true, false, false});
+    }
+
+    void JSONWriter::end_object() {
+        end_container(true);
+    }
+
+    void JSONWriter::start_array() {
+        begin_value();
+        *out_ += '[';
+        open_.push_back(OpenContainer{false, false, false});
+    }
+
+    void JSONWriter::end_array() {
+        end_container(false);
+    }
+
+    void JSONWriter::key(std::string_view name) {
+        if (open_.empty() || !open_.back().is_object || open_.back().expects_value) {
+            fail("Key written outside an object member position");
+            return;
+        }
+        OpenContainer& object = open_.back();
+        if (object.has_items) {
+            *out_ += ',';
+        }
+        object.has_items = true;
+        object.expects_value = true;
+        append_escaped(name, *out_);
+        *out_ += ':';
+    }
+
+    void JSONWriter::string(std::string_view value) {
+        begin_value();
+        append_escaped(value, *out_);
+        maybe_flush();
+    }
+
+    void JSONWriter::number(std::string_view text) {
+        begin_value();
+        out_->append(text.data(), text.size());
+        maybe_flush();
+    }
+
+    void JSONWriter::boolean(bool value) {
+        begin_value();
+        *out_ += value ? "true" : "false";
+        maybe_flush();
+    }
+
+    void JSONWriter::null() {
+        begin_value();
+        *out_ += "null";
+        maybe_flush();
+    }
+
+    void JSONWriter::defer() {
+        defer_next_ = true;
+    }
+
+    void JSONWriter::release() {
+        if (deferred_.empty()) {
+            fail("No deferred value to release");
+            return;
+        }
+        deferred_.pop_back();
+        maybe_flush();
+    }
+
+    bool JSONWriter::wrap_in_array() {
+        if (deferred_.empty()) {
+            fail("No deferred value to wrap");
+            return false;
+        }
+        size_t position = deferred_.back();
+        deferred_.pop_back();
+        if (position == std::string::npos) {
+            return false;
+        }
+        out_->insert(position, 1, '[');
+        open_.push_back(OpenContainer{false, true, false});
+        return true;
+    }
+
+    bool JSONWriter::flush() {
+        // Deferred values may still change, so output from the oldest one is held back
+        size_t ready = held_from();
+        if (sink_ == Sink::Buffer || ready == 0) {
+            return good();
+        }
+
+        if (good()) {
+            if (sink_ == Sink::Stream) {
+                stream_->write(buffer_.data(), static_cast<std::streamsize>(ready));
+                if (!*stream_) {
+                    fail("Failed to write to stream");
+                }
+            } else {
+                const char* data = buffer_.data();
+                size_t remaining = ready;
+                while (remaining > 0) {
+#ifdef _WIN32
+                    unsigned int chunk = static_cast<unsigned int>(std::min<size_t>(remaining, 1u << 30));
+                    int written = _write(fd_, data, chunk);
+#else
+                    ssize_t written = ::write(fd_, data, remaining);
+                    if (written < 0 && errno == EINTR) {
+                        continue;
+                    }
+#endif
+                    if (written <= 0) {
+                        fail("Failed to write to file");
+                        break;
+                    }
+                    data += written;
+                    remaining -= static_cast<size_t>(written);
+                }
+            }
+        }
+
+        // Dropped after a failure too, so memory stays bounded
+        buffer_.erase(0, ready);
+        for (auto& position : deferred_) {
+            if (position != std::string::npos) {
+                position -= ready;
+            }
+        }
+        return good();
+    }
+
+    bool JSONWriter::close() {
+        if (!deferred_.empty()) {
+            fail("Deferred value was not resolved");
+            deferred_.clear();
+        }
+        bool ok = flush();
+        if (sink_ == Sink::Stream && ok) {
+            stream_->flush();
+        }
+        if (owns_fd_) {
+#ifdef _WIN32
+            bool closed = _close(fd_) == 0;
+#else
+            bool closed = ::close(fd_) == 0;
+#endif
+            if (!closed) {
+                fail("Failed to close file");
+                ok = false;
+            }
+            owns_fd_ = false;
+            fd_ = -1;
+            sink_ = Sink::Buffer;
+        }
+        return ok;
+    }
+
+    void JSONWriter::reset() {
+        close();
+        sink_ = Sink::Buffer;
+        buffer_.clear();
+        out_ = &buffer_;
+        stream_ = nullptr;
+        fd_ = -1;
+        written_ = false;
+        error_.clear();
+        open_.clear();
+        deferred_.clear();
+        defer_next_ = false;
+    }
+
+    void JSONWriter::fail(const char* message) {
+        if (error_.empty()) {
+            error_ = message;
+        }
+    }
+
+    void JSONWriter::begin_value() {
+        if (open_.empty()) {
+            if (written_) {
+                fail("More than one top-level value");
+            }
+            written_ = true;
+        } else {
+            OpenContainer& parent = open_.back();
+            if (parent.is_object) {
+                if (!parent.expects_value) {
+                    fail("Object member written without a key");
+                }
+                parent.expects_value = false;
+            } else {
+                if (parent.has_items) {
+                    *out_ += ',';
+                }
+                parent.has_items = true;
+            }
+        }
+
+        if (defer_next_) {
+            deferred_.push_back(out_->size());
+            defer_next_ = false;
+        }
+    }
+
+    void JSONWriter::end_container(bool is_object) {
+        if (open_.empty() || open_.back().is_object != is_object || open_.back().expects_value) {
+            fail(is_object ? "No open object to close" : "No open array to close");
+            return;
+        }
+        *out_ += is_object ? '}' : ']';
+        open_.pop_back();
+        maybe_flush();
+    }
+
+    size_t JSONWriter::held_from() const {
+        for (size_t position : deferred_) {
+            if (position != std::string::npos) {
+                return position;
+            }
+        }
+        return out_->size();
+    }
+
+    void JSONWriter::maybe_flush() {
+        if (sink_ == Sink::Buffer || buffer_.size() < kFlushSize) {
+            return;
+        }
+        // Past the limit the oldest deferred values are written out as they are
+        for (auto& position : deferred_) {
+            if (buffer_.size() - held_from() <= defer_limit_) {
+                break;
+            }
+            position = std::string::npos;
+        }
+        if (held_from() >= kFlushSize) {
+            flush();
+        }
+    }
+
+} // namespace parser
@@ -0,0 +1,139 @@
+#include "parsers/mapped_file.h"
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace parser {
+
+    MappedFile::~MappedFile() {
+        close();
+    }
+
+    MappedFile::MappedFile(MappedFile&& other) noexcept {
+        *this = std::move(other);
+    }
+
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            close();
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+            open_ = std::exchange(other.open_, false);
+#ifdef _WIN32
+            file_handle_ = std::exchange(other.file_handle_, nullptr);
+            mapping_handle_ = std::exchange(other.mapping_handle_, nullptr);
+#endif
+        }
+        return *this;
+    }
+
+#ifdef _WIN32
+    bool MappedFile::open(const std::string& filename) {
+        close();
+
+        HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                  OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+
+        LARGE_INTEGER file_size;
+        if (!GetFileSizeEx(file, &file_size)) {
+            CloseHandle(file);
+            return false;
+        }
+
+        file_handle_ = file;
+        open_ = true;
+        if (file_size.QuadPart == 0) {
+            return true;
+        }
+
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping) {
+            close();
+            return false;
+        }
+        mapping_handle_ = mapping;
+
+        void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (!view) {
+            close();
+            return false;
+        }
+
+        data_ = static_cast<const char*>(view);
+        size_ = static_cast<size_t>(file_size.QuadPart);
+        return true;
+    }
+
+    void MappedFile::close() {
+        if (data_) {
+            UnmapViewOfFile(data_);
+        }
+        if (mapping_handle_) {
+            CloseHandle(static_cast<HANDLE>(mapping_handle_));
+        }
+        if (file_handle_) {
+            CloseHandle(static_cast<HANDLE>(file_handle_));
+        }
+        data_ = nullptr;
+        size_ = 0;
+        open_ = false;
+        file_handle_ = nullptr;
+        mapping_handle_ = nullptr;
+    }
+#else
+    bool MappedFile::open(const std::string& filename) {
+        close();
+
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            ::close(fd);
+            return false;
+        }
+
+        open_ = true;
+        if (st.st_size == 0) {
+            ::close(fd);
+            return true;
+        }
+
+        void* view = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd); // The mapping keeps its own reference to the file
+        if (view == MAP_FAILED) {
+            open_ = false;
+            return false;
+        }
+
+        data_ = static_cast<const char*>(view);
+        size_ = static_cast<size_t>(st.st_size);
+        return true;
+    }
+
+    void MappedFile::close() {
+        if (data_) {
+            munmap(const_cast<char*>(data_), size_);
+        }
+        data_ = nullptr;
+        size_ = 0;
+        open_ = false;
+    }
+#endif
+
+} // namespace parser
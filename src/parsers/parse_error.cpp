@@ -0,0 +1,30 @@
+#include "parsers/parse_error.h"
+#include <cstring>
+
+namespace parser {
+
+    ErrorLocation ErrorLocation::from_offset(const std::string& content, size_t offset) {
+        ErrorLocation location;
+        location.offset = offset < content.length() ? offset : content.length();
+        location.line = 1;
+
+        const char* data = content.data();
+        const char* end = data + location.offset;
+        const char* line_start = data;
+        while (const void* newline = std::memchr(line_start, '\n', end - line_start)) {
+            line_start = static_cast<const char*>(newline) + 1;
+            location.line++;
+        }
+
+        location.column = static_cast<size_t>(end - line_start) + 1;
+        return location;
+    }
+
+    std::string ErrorLocation::to_string() const {
+        if (line == 0) {
+            return "offset " + std::to_string(offset);
+        }
+        return "line " + std::to_string(line) + ", column " + std::to_string(column);
+    }
+
+} // namespace parser
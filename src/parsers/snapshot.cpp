@@ -0,0 +1,797 @@
+#include "parsers/snapshot.h"
+#include <fstream>
+#include <cstring>
+#include <unordered_map>
+
+namespace parser {
+
+    namespace detail {
+
+        struct SnapshotHeader {
+            char magic[4];
+            uint32_t byte_order;
+            uint32_t version;
+            uint32_t kind;
+            uint64_t node_count;
+            uint64_t nodes_offset;
+            uint64_t attribute_count;
+            uint64_t attributes_offset;
+            uint64_t strings_offset;
+            uint64_t strings_size;
+        };
+
+        // String: a = offset, b = length
+        // Integer/Number/Boolean: a = value bits
+        // Object/Array: a = first child index, b = child count
+        struct SnapshotJSONNode {
+            uint32_t type;
+            uint32_t key_length;
+            uint64_t key_offset;
+            uint64_t a;
+            uint64_t b;
+        };
+
+        struct SnapshotXMLNode {
+            uint64_t name_offset;
+            uint64_t name_length;
+            uint64_t value_offset;
+            uint64_t value_length;
+            uint64_t first_attribute;
+            uint64_t attribute_count;
+            uint64_t first_child;
+            uint64_t child_count;
+        };
+
+        struct SnapshotXMLAttribute {
+            uint64_t name_offset;
+            uint64_t name_length;
+            uint64_t value_offset;
+            uint64_t value_length;
+        };
+
+    } // namespace detail
+
+    namespace {
+
+        using detail::SnapshotHeader;
+        using detail::SnapshotJSONNode;
+        using detail::SnapshotXMLNode;
+        using detail::SnapshotXMLAttribute;
+
+        constexpr char kSnapshotMagic[4] = {'P', 'S', 'N', 'P'};
+        constexpr uint32_t kSnapshotByteOrder = 0x01020304;
+        constexpr uint32_t kSnapshotVersion = 1;
+        constexpr uint32_t kSnapshotJSON = 1;
+        constexpr uint32_t kSnapshotXML = 2;
+
+        const SnapshotHeader* header_of(const char* image) {
+            return reinterpret_cast<const SnapshotHeader*>(image);
+        }
+
+        std::string_view string_at(const char* image, uint64_t offset, uint64_t length) {
+            const SnapshotHeader* header = header_of(image);
+            if (offset > header->strings_size || length > header->strings_size - offset) {
+                return {};
+            }
+            return std::string_view(image + header->strings_offset + offset, static_cast<size_t>(length));
+        }
+
+        template <typename Node>
+        const Node* node_at(const char* image, uint64_t index) {
+            const SnapshotHeader* header = header_of(image);
+            if (index >= header->node_count) {
+                return nullptr;
+            }
+            return reinterpret_cast<const Node*>(image + header->nodes_offset) + index;
+        }
+
+        /**
+         * Children are laid out breadth-first, so they always come after
+         * their parent. Links that point back are rejected, which keeps a
+         * corrupt image from sending recursive walks into a cycle.
+         */
+        template <typename Node>
+        const Node* child_at(const char* image, const Node* parent, uint64_t first_child, uint64_t index) {
+            const SnapshotHeader* header = header_of(image);
+            uint64_t parent_index = static_cast<uint64_t>(parent - reinterpret_cast<const Node*>(image + header->nodes_offset));
+            if (first_child <= parent_index || first_child >= header->node_count ||
+                index >= header->node_count - first_child) {
+                return nullptr;
+            }
+            return node_at<Node>(image, first_child + index);
+        }
+
+        /**
+         * Collects string pool, node and attribute tables, then emits the image
+         */
+        class ImageBuilder {
+        public:
+            uint64_t add_string(std::string_view str) {
+                uint64_t offset = strings_.size();
+                strings_ += str;
+                return offset;
+            }
+
+            // Names and keys repeat heavily, so they are stored once
+            uint64_t add_name(std::string_view name) {
+                std::string key(name);
+                auto it = names_.find(key);
+                if (it != names_.end()) {
+                    return it->second;
+                }
+                uint64_t offset = add_string(name);
+                names_.emplace(std::move(key), offset);
+                return offset;
+            }
+
+            template <typename Node, typename Attribute, typename Sink>
+            void emit(uint32_t kind, const std::vector<Node>& nodes, const std::vector<Attribute>& attributes, Sink&& sink) const {
+                SnapshotHeader header{};
+                std::memcpy(header.magic, kSnapshotMagic, sizeof(header.magic));
+                header.byte_order = kSnapshotByteOrder;
+                header.version = kSnapshotVersion;
+                header.kind = kind;
+                header.node_count = nodes.size();
+                header.nodes_offset = sizeof(SnapshotHeader);
+                header.attribute_count = attributes.size();
+                header.attributes_offset = header.nodes_offset + nodes.size() * sizeof(Node);
+                header.strings_offset = header.attributes_offset + attributes.size() * sizeof(Attribute);
+                header.strings_size = strings_.size();
+
+                sink(reinterpret_cast<const char*>(&header), sizeof(header));
+                sink(reinterpret_cast<const char*>(nodes.data()), nodes.size() * sizeof(Node));
+                sink(reinterpret_cast<const char*>(attributes.data()), attributes.size() * sizeof(Attribute));
+                sink(strings_.data(), strings_.size());
+            }
+
+        private:
+            std::string strings_;
+            std::unordered_map<std::string, uint64_t> names_;
+        };
+
+        struct NoAttribute {};
+
+        class JSONImage {
+        public:
+            explicit JSONImage(const JSONValue& root) {
+                // Breadth-first, so the children of every container are contiguous
+                std::vector<const JSONValue*> queue;
+                queue.push_back(&root);
+                nodes_.push_back(SnapshotJSONNode{});
+
+                for (size_t i = 0; i < queue.size(); ++i) {
+                    const JSONValue& value = *queue[i];
+                    SnapshotJSONNode& node = nodes_[i];
+                    node.type = static_cast<uint32_t>(value.get_type());
+
+                    switch (value.get_type()) {
+                        case JSONValue::Type::String: {
+                            std::string str = value.as_string();
+                            node.a = builder_.add_string(str);
+                            node.b = str.size();
+                            break;
+                        }
+                        case JSONValue::Type::Integer:
+                            node.a = static_cast<uint64_t>(static_cast<int64_t>(value.as_int()));
+                            break;
+                        case JSONValue::Type::Number: {
+                            double number = value.as_double();
+                            std::memcpy(&node.a, &number, sizeof(number));
+                            break;
+                        }
+                        case JSONValue::Type::Boolean:
+                            node.a = value.as_bool() ? 1 : 0;
+                            break;
+                        case JSONValue::Type::Object: {
+                            uint64_t first = nodes_.size();
+                            for (const auto& pair : value.object_items()) {
+                                SnapshotJSONNode child{};
+                                child.key_offset = builder_.add_name(pair.first);
+                                child.key_length = static_cast<uint32_t>(pair.first.size());
+                                queue.push_back(&pair.second);
+                                nodes_.push_back(child);
+                            }
+                            nodes_[i].a = first;
+                            nodes_[i].b = value.object_items().size();
+                            break;
+                        }
+                        case JSONValue::Type::Array: {
+                            uint64_t first = nodes_.size();
+                            for (const auto& item : value.array_items()) {
+                                queue.push_back(&item);
+                                nodes_.push_back(SnapshotJSONNode{});
+                            }
+                            nodes_[i].a = first;
+                            nodes_[i].b = value.array_items().size();
+                            break;
+                        }
+                        default:
+                            break;
+                    }
+                }
+            }
+
+            template <typename Sink>
+            void emit(Sink&& sink) const {
+                builder_.emit(kSnapshotJSON, nodes_, std::vector<NoAttribute>{}, sink);
+            }
+
+        private:
+            ImageBuilder builder_;
+            std::vector<SnapshotJSONNode> nodes_;
+        };
+
+        class XMLImage {
+        public:
+            explicit XMLImage(const XMLNode& root) {
+                std::vector<const XMLNode*> queue;
+                queue.push_back(&root);
+                nodes_.push_back(SnapshotXMLNode{});
+
+                for (size_t i = 0; i < queue.size(); ++i) {
+                    const XMLNode& element = *queue[i];
+                    SnapshotXMLNode node{};
+                    node.name_offset = builder_.add_name(element.name);
+                    node.name_length = element.name.size();
+                    node.value_offset = builder_.add_string(element.value);
+                    node.value_length = element.value.size();
+
+                    node.first_attribute = attributes_.size();
+                    node.attribute_count = element.attributes.size();
+                    for (const auto& attr : element.attributes) {
+                        SnapshotXMLAttribute attribute{};
+                        attribute.name_offset = builder_.add_name(attr.name);
+                        attribute.name_length = attr.name.size();
+                        attribute.value_offset = builder_.add_string(attr.value);
+                        attribute.value_length = attr.value.size();
+                        attributes_.push_back(attribute);
+                    }
+
+                    node.first_child = nodes_.size();
+                    for (const auto& child : element.children) {
+                        if (child.is_element()) {
+                            queue.push_back(&child);
+                            nodes_.push_back(SnapshotXMLNode{});
+                        }
+                    }
+                    node.child_count = nodes_.size() - node.first_child;
+                    nodes_[i] = node;
+                }
+            }
+
+            template <typename Sink>
+            void emit(Sink&& sink) const {
+                builder_.emit(kSnapshotXML, nodes_, attributes_, sink);
+            }
+
+        private:
+            ImageBuilder builder_;
+            std::vector<SnapshotXMLNode> nodes_;
+            std::vector<SnapshotXMLAttribute> attributes_;
+        };
+
+        template <typename Image>
+        std::string image_to_bytes(const Image& image) {
+            std::string out;
+            image.emit([&out](const char* data, size_t size) { out.append(data, size); });
+            return out;
+        }
+
+        template <typename Image>
+        bool save_image(const Image& image, const std::string& filename) {
+            std::ofstream file(filename, std::ios::binary);
+            if (!file.is_open()) {
+                return false;
+            }
+
+            image.emit([&file](const char* data, size_t size) {
+                file.write(data, static_cast<std::streamsize>(size));
+            });
+            return static_cast<bool>(file);
+        }
+
+        // Checks header fields and that every table lies inside the image
+        bool validate_image(const char* data, size_t size, uint32_t kind, size_t node_size,
+                            size_t attribute_size, std::string& error) {
+            if (size < sizeof(SnapshotHeader)) {
+                error = "Snapshot image is too small";
+                return false;
+            }
+            if (reinterpret_cast<uintptr_t>(data) % alignof(SnapshotHeader) != 0) {
+                error = "Snapshot image is not aligned";
+                return false;
+            }
+
+            const SnapshotHeader* header = header_of(data);
+            if (std::memcmp(header->magic, kSnapshotMagic, sizeof(kSnapshotMagic)) != 0) {
+                error = "Not a snapshot image";
+                return false;
+            }
+            if (header->byte_order != kSnapshotByteOrder) {
+                error = "Snapshot image has a different byte order";
+                return false;
+            }
+            if (header->version != kSnapshotVersion) {
+                error = "Unsupported snapshot version: " + std::to_string(header->version);
+                return false;
+            }
+            if (header->kind != kind) {
+                error = "Snapshot image holds a different document type";
+                return false;
+            }
+
+            auto fits = [size](uint64_t offset, uint64_t count, uint64_t element_size) {
+                return offset <= size && offset % 8 == 0 &&
+                       (element_size == 0 || count <= (size - offset) / element_size);
+            };
+            if (header->node_count == 0 ||
+                !fits(header->nodes_offset, header->node_count, node_size) ||
+                !fits(header->attributes_offset, header->attribute_count, attribute_size) ||
+                header->strings_offset > size || header->strings_size > size - header->strings_offset) {
+                error = "Corrupt snapshot image";
+                return false;
+            }
+            return true;
+        }
+
+        // Splits a dotted path without allocating
+        template <typename Visitor>
+        bool for_each_component(const std::string& path, bool skip_empty, Visitor&& visit) {
+            std::string_view rest(path);
+            while (!rest.empty()) {
+                size_t dot = rest.find('.');
+                std::string_view component = rest.substr(0, dot);
+                rest = dot == std::string_view::npos ? std::string_view() : rest.substr(dot + 1);
+                if (component.empty() && skip_empty) {
+                    continue;
+                }
+                if (!visit(component)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+    } // namespace
+
+    // JSONSnapshotValue implementation
+    JSONValue::Type JSONSnapshotValue::get_type() const {
+        return node_ ? static_cast<JSONValue::Type>(node_->type) : JSONValue::Type::Null;
+    }
+
+    std::string_view JSONSnapshotValue::as_string_view() const {
+        if (get_type() != JSONValue::Type::String) {
+            return {};
+        }
+        return string_at(image_, node_->a, node_->b);
+    }
+
+    std::string JSONSnapshotValue::as_string() const {
+        if (is_object() || is_array()) {
+            return "";
+        }
+        return to_value().as_string();
+    }
+
+    int JSONSnapshotValue::as_int() const {
+        switch (get_type()) {
+            case JSONValue::Type::Integer:
+                return static_cast<int>(static_cast<int64_t>(node_->a));
+            case JSONValue::Type::Object:
+            case JSONValue::Type::Array:
+                return 0;
+            default:
+                return to_value().as_int();
+        }
+    }
+
+    double JSONSnapshotValue::as_double() const {
+        if (get_type() == JSONValue::Type::Number) {
+            double value;
+            std::memcpy(&value, &node_->a, sizeof(value));
+            return value;
+        }
+        if (is_object() || is_array()) {
+            return 0.0;
+        }
+        return to_value().as_double();
+    }
+
+    bool JSONSnapshotValue::as_bool() const {
+        if (get_type() == JSONValue::Type::Boolean) {
+            return node_->a != 0;
+        }
+        if (is_object() || is_array()) {
+            return false;
+        }
+        return to_value().as_bool();
+    }
+
+    std::string_view JSONSnapshotValue::key() const {
+        return string_at(image_, node_->key_offset, node_->key_length);
+    }
+
+    JSONSnapshotValue JSONSnapshotValue::child(uint64_t index) const {
+        const SnapshotJSONNode* node = child_at(image_, node_, node_->a, index);
+        return node ? JSONSnapshotValue(image_, node) : JSONSnapshotValue();
+    }
+
+    JSONSnapshotValue JSONSnapshotValue::get(std::string_view key_name) const {
+        if (!is_object()) {
+            return JSONSnapshotValue();
+        }
+
+        // Members are stored in key order
+        uint64_t low = 0;
+        uint64_t high = node_->b;
+        while (low < high) {
+            uint64_t mid = low + (high - low) / 2;
+            JSONSnapshotValue member = child(mid);
+            if (!member.node_) {
+                return JSONSnapshotValue();
+            }
+            int cmp = member.key().compare(key_name);
+            if (cmp == 0) {
+                return member;
+            }
+            if (cmp < 0) {
+                low = mid + 1;
+            } else {
+                high = mid;
+            }
+        }
+        return JSONSnapshotValue();
+    }
+
+    bool JSONSnapshotValue::has_key(std::string_view key_name) const {
+        return get(key_name).node_ != nullptr;
+    }
+
+    std::vector<std::string> JSONSnapshotValue::get_keys() const {
+        std::vector<std::string> keys;
+        if (is_object()) {
+            keys.reserve(static_cast<size_t>(node_->b));
+            for (uint64_t i = 0; i < node_->b; ++i) {
+                JSONSnapshotValue member = child(i);
+                if (member.node_) {
+                    keys.emplace_back(member.key());
+                }
+            }
+        }
+        return keys;
+    }
+
+    JSONSnapshotValue JSONSnapshotValue::at(size_t index) const {
+        if (!is_array() || index >= node_->b) {
+            return JSONSnapshotValue();
+        }
+        return child(index);
+    }
+
+    size_t JSONSnapshotValue::size() const {
+        if (is_array() || is_object()) {
+            return static_cast<size_t>(node_->b);
+        }
+        return 0;
+    }
+
+    JSONValue JSONSnapshotValue::to_value() const {
+        switch (get_type()) {
+            case JSONValue::Type::String:
+                return JSONValue(std::string(as_string_view()));
+            case JSONValue::Type::Integer:
+                return JSONValue(as_int());
+            case JSONValue::Type::Number:
+                return JSONValue(as_double());
+            case JSONValue::Type::Boolean:
+                return JSONValue(as_bool());
+            case JSONValue::Type::Object: {
+                JSONValue obj = JSONValue::make(JSONValue::Type::Object);
+                for (uint64_t i = 0; i < node_->b; ++i) {
+                    JSONSnapshotValue member = child(i);
+                    if (member.node_) {
+                        obj.set(std::string(member.key()), member.to_value());
+                    }
+                }
+                return obj;
+            }
+            case JSONValue::Type::Array: {
+                JSONValue arr = JSONValue::make(JSONValue::Type::Array);
+                for (uint64_t i = 0; i < node_->b; ++i) {
+                    arr.push_back(child(i).to_value());
+                }
+                return arr;
+            }
+            default:
+                return JSONValue();
+        }
+    }
+
+    // JSONSnapshot implementation
+    bool JSONSnapshot::save(const JSONResult& result, const std::string& filename) {
+        return save_image(JSONImage(result.root), filename);
+    }
+
+    std::string JSONSnapshot::to_bytes(const JSONResult& result) {
+        return image_to_bytes(JSONImage(result.root));
+    }
+
+    JSONSnapshot JSONSnapshot::open(const std::string& filename) {
+        JSONSnapshot snapshot;
+        if (!snapshot.file_.open(filename)) {
+            snapshot.error_message = "Cannot open file: " + filename;
+            return snapshot;
+        }
+        snapshot.attach(snapshot.file_.data(), snapshot.file_.size());
+        return snapshot;
+    }
+
+    JSONSnapshot JSONSnapshot::from_bytes(const std::string& data) {
+        JSONSnapshot snapshot;
+        snapshot.buffer_.resize((data.size() + 7) / 8);
+        if (!data.empty()) {
+            std::memcpy(snapshot.buffer_.data(), data.data(), data.size());
+        }
+        snapshot.attach(reinterpret_cast<const char*>(snapshot.buffer_.data()), data.size());
+        return snapshot;
+    }
+
+    bool JSONSnapshot::attach(const char* data, size_t size) {
+        success = validate_image(data, size, kSnapshotJSON, sizeof(SnapshotJSONNode), 0, error_message);
+        image_ = success ? data : nullptr;
+        return success;
+    }
+
+    JSONSnapshotValue JSONSnapshot::root() const {
+        if (!image_) {
+            return JSONSnapshotValue();
+        }
+        return JSONSnapshotValue(image_, node_at<SnapshotJSONNode>(image_, 0));
+    }
+
+    std::string JSONSnapshot::get_string(const std::string& path, const std::string& default_value) const {
+        JSONSnapshotValue value = get_value(path);
+        if (value.get_type() == JSONValue::Type::Null) {
+            return default_value;
+        }
+        return value.as_string();
+    }
+
+    int JSONSnapshot::get_int(const std::string& path, int default_value) const {
+        JSONSnapshotValue value = get_value(path);
+        if (value.get_type() == JSONValue::Type::Null) {
+            return default_value;
+        }
+        return value.as_int();
+    }
+
+    double JSONSnapshot::get_double(const std::string& path, double default_value) const {
+        JSONSnapshotValue value = get_value(path);
+        if (value.get_type() == JSONValue::Type::Null) {
+            return default_value;
+        }
+        return value.as_double();
+    }
+
+    bool JSONSnapshot::get_bool(const std::string& path, bool default_value) const {
+        JSONSnapshotValue value = get_value(path);
+        if (value.get_type() == JSONValue::Type::Null) {
+            return default_value;
+        }
+        return value.as_bool();
+    }
+
+    JSONSnapshotValue JSONSnapshot::get_value(const std::string& path) const {
+        JSONSnapshotValue current = root();
+        bool found = for_each_component(path, false, [&current](std::string_view component) {
+            current = current.get(component);
+            return current.get_type() != JSONValue::Type::Null;
+        });
+        return found ? current : JSONSnapshotValue();
+    }
+
+    bool JSONSnapshot::has_path(const std::string& path) const {
+        return get_value(path).get_type() != JSONValue::Type::Null;
+    }
+
+    std::vector<std::string> JSONSnapshot::get_keys(const std::string& path) const {
+        return get_value(path).get_keys();
+    }
+
+    // XMLSnapshotNode implementation
+    std::string_view XMLSnapshotNode::name() const {
+        return node_ ? string_at(image_, node_->name_offset, node_->name_length) : std::string_view();
+    }
+
+    std::string_view XMLSnapshotNode::value() const {
+        return node_ ? string_at(image_, node_->value_offset, node_->value_length) : std::string_view();
+    }
+
+    size_t XMLSnapshotNode::child_count() const {
+        return node_ ? static_cast<size_t>(node_->child_count) : 0;
+    }
+
+    XMLSnapshotNode XMLSnapshotNode::child(size_t index) const {
+        if (!node_ || index >= node_->child_count) {
+            return XMLSnapshotNode();
+        }
+        const SnapshotXMLNode* node = child_at(image_, node_, node_->first_child, index);
+        return node ? XMLSnapshotNode(image_, node) : XMLSnapshotNode();
+    }
+
+    XMLSnapshotNode XMLSnapshotNode::get_child(std::string_view child_name) const {
+        for (size_t i = 0; i < child_count(); ++i) {
+            XMLSnapshotNode candidate = child(i);
+            if (candidate && candidate.name() == child_name) {
+                return candidate;
+            }
+        }
+        return XMLSnapshotNode();
+    }
+
+    std::vector<XMLSnapshotNode> XMLSnapshotNode::get_children(std::string_view child_name) const {
+        std::vector<XMLSnapshotNode> result;
+        for (size_t i = 0; i < child_count(); ++i) {
+            XMLSnapshotNode candidate = child(i);
+            if (candidate && candidate.name() == child_name) {
+                result.push_back(candidate);
+            }
+        }
+        return result;
+    }
+
+    size_t XMLSnapshotNode::attribute_count() const {
+        return node_ ? static_cast<size_t>(node_->attribute_count) : 0;
+    }
+
+    std::string_view XMLSnapshotNode::attribute_name(size_t index) const {
+        if (index >= attribute_count()) {
+            return {};
+        }
+        const SnapshotHeader* header = header_of(image_);
+        uint64_t slot = node_->first_attribute + index;
+        if (slot >= header->attribute_count) {
+            return {};
+        }
+        const auto* attr = reinterpret_cast<const SnapshotXMLAttribute*>(image_ + header->attributes_offset) + slot;
+        return string_at(image_, attr->name_offset, attr->name_length);
+    }
+
+    std::string_view XMLSnapshotNode::attribute_value(size_t index) const {
+        if (index >= attribute_count()) {
+            return {};
+        }
+        const SnapshotHeader* header = header_of(image_);
+        uint64_t slot = node_->first_attribute + index;
+        if (slot >= header->attribute_count) {
+            return {};
+        }
+        const auto* attr = reinterpret_cast<const SnapshotXMLAttribute*>(image_ + header->attributes_offset) + slot;
+        return string_at(image_, attr->value_offset, attr->value_length);
+    }
+
+    const detail::SnapshotXMLAttribute* XMLSnapshotNode::find_attribute(std::string_view attr_name) const {
+        if (!node_) {
+            return nullptr;
+        }
+        const SnapshotHeader* header = header_of(image_);
+        if (node_->first_attribute > header->attribute_count ||
+            node_->attribute_count > header->attribute_count - node_->first_attribute) {
+            return nullptr;
+        }
+
+        const auto* attrs = reinterpret_cast<const SnapshotXMLAttribute*>(image_ + header->attributes_offset) + node_->first_attribute;
+        for (uint64_t i = 0; i < node_->attribute_count; ++i) {
+            if (string_at(image_, attrs[i].name_offset, attrs[i].name_length) == attr_name) {
+                return &attrs[i];
+            }
+        }
+        return nullptr;
+    }
+
+    std::string XMLSnapshotNode::get_attribute(std::string_view attr_name, const std::string& default_value) const {
+        const SnapshotXMLAttribute* attr = find_attribute(attr_name);
+        if (!attr) {
+            return default_value;
+        }
+        return std::string(string_at(image_, attr->value_offset, attr->value_length));
+    }
+
+    bool XMLSnapshotNode::has_attribute(std::string_view attr_name) const {
+        return find_attribute(attr_name) != nullptr;
+    }
+
+    // XMLSnapshot implementation
+    bool XMLSnapshot::save(const XMLResult& result, const std::string& filename) {
+        return save_image(XMLImage(result.root), filename);
+    }
+
+    std::string XMLSnapshot::to_bytes(const XMLResult& result) {
+        return image_to_bytes(XMLImage(result.root));
+    }
+
+    XMLSnapshot XMLSnapshot::open(const std::string& filename) {
+        XMLSnapshot snapshot;
+        if (!snapshot.file_.open(filename)) {
+            snapshot.error_message = "Cannot open file: " + filename;
+            return snapshot;
+        }
+        snapshot.attach(snapshot.file_.data(), snapshot.file_.size());
+        return snapshot;
+    }
+
+    XMLSnapshot XMLSnapshot::from_bytes(const std::string& data) {
+        XMLSnapshot snapshot;
+        snapshot.buffer_.resize((data.size() + 7) / 8);
+        if (!data.empty()) {
+            std::memcpy(snapshot.buffer_.data(), data.data(), data.size());
+        }
+        snapshot.attach(reinterpret_cast<const char*>(snapshot.buffer_.data()), data.size());
+        return snapshot;
+    }
+
+    bool XMLSnapshot::attach(const char* data, size_t size) {
+        success = validate_image(data, size, kSnapshotXML, sizeof(SnapshotXMLNode),
+                                 sizeof(SnapshotXMLAttribute), error_message);
+        image_ = success ? data : nullptr;
+        return success;
+    }
+
+    XMLSnapshotNode XMLSnapshot::root() const {
+        if (!image_) {
+            return XMLSnapshotNode();
+        }
+        return XMLSnapshotNode(image_, node_at<SnapshotXMLNode>(image_, 0));
+    }
+
+    std::string XMLSnapshot::get_value(const std::string& path, const std::string& default_value) const {
+        XMLSnapshotNode node = get_node(path);
+        if (node) {
+            return std::string(node.value());
+        }
+        return default_value;
+    }
+
+    std::string XMLSnapshot::get_attribute(const std::string& path, const std::string& attr_name, const std::string& default_value) const {
+        XMLSnapshotNode node = get_node(path);
+        if (node) {
+            return node.get_attribute(attr_name, default_value);
+        }
+        return default_value;
+    }
+
+    XMLSnapshotNode XMLSnapshot::get_node(const std::string& path) const {
+        XMLSnapshotNode current = root();
+        if (!current) {
+            return current;
+        }
+        bool found = for_each_component(path, true, [&current](std::string_view component) {
+            current = current.get_child(component);
+            return static_cast<bool>(current);
+        });
+        return found ? current : XMLSnapshotNode();
+    }
+
+    bool XMLSnapshot::has_path(const std::string& path) const {
+        return static_cast<bool>(get_node(path));
+    }
+
+    std::vector<std::string> XMLSnapshot::get_children(const std::string& path) const {
+        XMLSnapshotNode node = get_node(path);
+        std::vector<std::string> result;
+        for (size_t i = 0; i < node.child_count(); ++i) {
+            result.emplace_back(node.child(i).name());
+        }
+        return result;
+    }
+
+    std::vector<std::string> XMLSnapshot::get_attributes(const std::string& path) const {
+        XMLSnapshotNode node = get_node(path);
+        std::vector<std::string> result;
+        for (size_t i = 0; i < node.attribute_count(); ++i) {
+            result.emplace_back(node.attribute_name(i));
+        }
+        return result;
+    }
+
+} // namespace parser
@@ -0,0 +1,503 @@
+#include "parsers/xml_document.h"
+#include "parsers/xml_scanner.h"
+
+namespace parser {
+
+    namespace {
+
+        // Copy one node, without its children, into the document below the given parent
+        uint32_t append_node(XMLDocument& doc, uint32_t parent, const XMLNode& node) {
+            uint32_t index = doc.append_child(parent, node.name);
+            doc.set_value(index, node.value);
+            doc.set_namespace_uri(index, node.namespace_uri());
+            for (const auto& attr : node.attributes) {
+                doc.set_attribute(index, attr.name, attr.value);
+                if (!attr.namespace_uri().empty()) {
+                    doc.set_attribute_namespace_uri(index, attr.name, attr.namespace_uri());
+                }
+            }
+            return index;
+        }
+
+        // Copy a node tree into the document below the given parent
+        void append_tree(XMLDocument& doc, uint32_t parent, const XMLNode& node) {
+            struct Frame {
+                const XMLNode* node;
+                uint32_t index;
+                size_t next_child;
+            };
+            // Explicit stack, so deep trees cannot exhaust the call stack
+            std::vector<Frame> stack;
+            stack.push_back(Frame{&node, append_node(doc, parent, node), 0});
+            while (!stack.empty()) {
+                Frame& top = stack.back();
+                if (top.next_child == top.node->children.size()) {
+                    stack.pop_back();
+                    continue;
+                }
+                const XMLNode& child = top.node->children[top.next_child++];
+                if (child.is_element()) {
+                    uint32_t index = append_node(doc, top.index, child);
+                    stack.push_back(Frame{&child, index, 0});
+                }
+            }
+        }
+
+        // Copy a document subtree into a node
+        void build_tree(XMLNodeRef ref, XMLNode& node) {
+            struct Frame {
+                XMLNodeRef ref;
+                XMLNode* node;
+            };
+            // Explicit stack, so deep documents cannot exhaust the call stack
+            std::vector<Frame> stack;
+            stack.push_back(Frame{ref, &node});
+            while (!stack.empty()) {
+                Frame frame = stack.back();
+                stack.pop_back();
+                XMLNode& current = *frame.node;
+                current.name = std::string(frame.ref.name());
+                current.value = std::string(frame.ref.value());
+                for (const auto& attr_name : frame.ref.get_attribute_names()) {
+                    current.set_attribute(attr_name, frame.ref.get_attribute(attr_name));
+                }
+                // Reserved up front, so the children stay put while their own children are built
+                current.children.reserve(frame.ref.child_count());
+                for (XMLNodeRef child = frame.ref.first_child(); child; child = child.next_sibling()) {
+                    stack.push_back(Frame{child, &current.add_child(XMLNode())});
+                }
+            }
+        }
+
+    } // namespace
+
+    // XMLNodeRef implementation
+    std::string_view XMLNodeRef::name() const {
+        return doc_ ? doc_->names_.name(doc_->nodes_[index_].name) : std::string_view();
+    }
+
+    std::string_view XMLNodeRef::value() const {
+        return doc_ ? doc_->view(doc_->nodes_[index_].value) : std::string_view();
+    }
+
+    uint32_t XMLNodeRef::name_id() const {
+        return doc_ ? doc_->nodes_[index_].name : XMLNameTable::npos;
+    }
+
+    std::string_view XMLNodeRef::namespace_uri() const {
+        return doc_ ? doc_->names_.name(doc_->nodes_[index_].namespace_uri) : std::string_view();
+    }
+
+    uint32_t XMLNodeRef::namespace_id() const {
+        return doc_ ? doc_->nodes_[index_].namespace_uri : XMLNameTable::npos;
+    }
+
+    std::string_view XMLNodeRef::local_name() const {
+        return XMLNamespaceScope::local_name(name());
+    }
+
+    XMLNodeRef XMLNodeRef::parent() const {
+        return doc_ ? doc_->node(doc_->nodes_[index_].parent) : XMLNodeRef();
+    }
+
+    XMLNodeRef XMLNodeRef::first_child() const {
+        return doc_ ? doc_->node(doc_->nodes_[index_].first_child) : XMLNodeRef();
+    }
+
+    XMLNodeRef XMLNodeRef::next_sibling() const {
+        return doc_ ? doc_->node(doc_->nodes_[index_].next_sibling) : XMLNodeRef();
+    }
+
+    size_t XMLNodeRef::child_count() const {
+        size_t count = 0;
+        for (XMLNodeRef child = first_child(); child; child = child.next_sibling()) {
+            ++count;
+        }
+        return count;
+    }
+
+    XMLNodeRef XMLNodeRef::get_child(std::string_view child_name) const {
+        if (!doc_) {
+            return XMLNodeRef();
+        }
+        return doc_->find_child(index_, doc_->names_.find(child_name));
+    }
+
+    std::vector<XMLNodeRef> XMLNodeRef::get_children(std::string_view child_name) const {
+        std::vector<XMLNodeRef> result;
+        if (!doc_) {
+            return result;
+        }
+        uint32_t id = doc_->names_.find(child_name);
+        if (id == XMLNameTable::npos) {
+            return result;
+        }
+        for (XMLNodeRef child = first_child(); child; child = child.next_sibling()) {
+            if (child.name_id() == id) {
+                result.push_back(child);
+            }
+        }
+        return result;
+    }
+
+    XMLNodeRef XMLNodeRef::get_child_ns(std::string_view namespace_uri, std::string_view local_name) const {
+        if (!doc_) {
+            return XMLNodeRef();
+        }
+        // Compare URIs by ID; a URI the document never interned matches nothing
+        uint32_t uri = namespace_uri.empty() ? XMLNameTable::npos : doc_->names_.find(namespace_uri);
+        if (!namespace_uri.empty() && uri == XMLNameTable::npos) {
+            return XMLNodeRef();
+        }
+        for (XMLNodeRef child = first_child(); child; child = child.next_sibling()) {
+            if (child.namespace_id() == uri && child.local_name() == local_name) {
+                return child;
+            }
+        }
+        return XMLNodeRef();
+    }
+
+    std::string XMLNodeRef::get_attribute_ns(std::string_view namespace_uri, std::string_view local_name, const std::string& default_value) const {
+        if (!doc_) {
+            return default_value;
+        }
+        uint32_t uri = namespace_uri.empty() ? XMLNameTable::npos : doc_->names_.find(namespace_uri);
+        if (!namespace_uri.empty() && uri == XMLNameTable::npos) {
+            return default_value;
+        }
+        for (uint32_t i = doc_->nodes_[index_].first_attribute; i != XMLDocument::npos; i = doc_->attributes_[i].next) {
+            const XMLDocument::AttributeData& attr = doc_->attributes_[i];
+            if (attr.namespace_uri == uri && XMLNamespaceScope::local_name(doc_->names_.name(attr.name)) == local_name) {
+                return std::string(doc_->view(attr.value));
+            }
+        }
+        return default_value;
+    }
+
+    std::string XMLNodeRef::get_attribute(std::string_view attr_name, const std::string& default_value) const {
+        const XMLDocument::AttributeData* attr = doc_ ? doc_->find_attribute(index_, attr_name) : nullptr;
+        if (attr) {
+            return std::string(doc_->view(attr->value));
+        }
+        return default_value;
+    }
+
+    bool XMLNodeRef::has_attribute(std::string_view attr_name) const {
+        return doc_ && doc_->find_attribute(index_, attr_name) != nullptr;
+    }
+
+    std::vector<std::string> XMLNodeRef::get_attribute_names() const {
+        std::vector<std::string> result;
+        if (!doc_) {
+            return result;
+        }
+        for (uint32_t i = doc_->nodes_[index_].first_attribute; i != XMLDocument::npos; i = doc_->attributes_[i].next) {
+            result.emplace_back(doc_->names_.name(doc_->attributes_[i].name));
+        }
+        return result;
+    }
+
+    // XMLDocument implementation
+    XMLDocument XMLDocument::parse(const std::string& content, const XMLParseOptions& options) {
+        XMLReader reader;
+        reader.set_namespace_aware(options.resolve_namespaces);
+        reader.set_limits(options.limits);
+        reader.open_buffer(content);
+        return parse_root(reader);
+    }
+
+    XMLDocument XMLDocument::parse_file(const std::string& filename, const XMLParseOptions& options) {
+        XMLReader reader;
+        reader.set_namespace_aware(options.resolve_namespaces);
+        reader.set_limits(options.limits);
+        reader.open(filename);
+        return parse_root(reader);
+    }
+
+    XMLDocument XMLDocument::read_element(XMLReader& reader) {
+        XMLDocument doc;
+        if (reader.event() == XMLReader::Event::Error) {
+            doc.error_message = reader.error_message();
+            doc.error_location = reader.error_location();
+            return doc;
+        }
+        if (reader.event() != XMLReader::Event::StartElement) {
+            doc.error_message = "Reader is not positioned on a start element";
+            return doc;
+        }
+
+        size_t element_depth = reader.depth();
+        uint32_t current = npos;
+        std::string text;
+        std::string attr_value;
+        // Reader URI ID -> document URI ID, so each URI is hashed once
+        std::vector<uint32_t> uri_ids;
+        auto document_uri = [&](uint32_t reader_id) {
+            if (reader_id == XMLNamespaceScope::npos) {
+                return npos;
+            }
+            if (reader_id >= uri_ids.size()) {
+                uri_ids.resize(reader.namespaces().uri_count(), npos);
+            }
+            if (uri_ids[reader_id] == npos) {
+                uri_ids[reader_id] = doc.names_.intern(reader.namespaces().uri(reader_id));
+            }
+            return uri_ids[reader_id];
+        };
+
+        for (XMLReader::Event event = reader.event();; event = reader.next()) {
+            switch (event) {
+                case XMLReader::Event::StartElement:
+                    current = doc.append_child(current, reader.name());
+                    for (size_t i = 0; i < reader.attribute_count(); ++i) {
+                        attr_value.clear();
+                        detail::decode_entities(reader.raw_attribute_value(i), attr_value);
+                        size_t attribute_count = doc.attributes_.size();
+                        doc.set_attribute(current, reader.attribute_name(i), attr_value);
+                        if (reader.namespace_aware() && doc.attributes_.size() > attribute_count) {
+                            doc.attributes_.back().namespace_uri = document_uri(reader.attribute_namespace_id(i));
+                        }
+                    }
+                    if (reader.namespace_aware()) {
+                        doc.nodes_[current].namespace_uri = document_uri(reader.namespace_id());
+                    }
+                    // Text of an element with children is dropped
+                    text.clear();
+                    break;
+                case XMLReader::Event::Text:
+                    detail::decode_entities(reader.raw_text(), text);
+                    break;
+                case XMLReader::Event::CData:
+                    text += reader.raw_text();
+                    break;
+                case XMLReader::Event::EndElement:
+                    if (doc.nodes_[current].first_child == npos) {
+                        doc.set_value(current, text);
+                    }
+                    text.clear();
+                    if (reader.depth() == element_depth) {
+                        doc.success = true;
+                        return doc;
+                    }
+                    current = doc.nodes_[current].parent;
+                    break;
+                case XMLReader::Event::Error: {
+                    XMLDocument failed;
+                    failed.error_message = reader.error_message();
+                    failed.error_location = reader.error_location();
+                    return failed;
+                }
+                default:
+                    break;
+            }
+        }
+    }
+
+    XMLDocument XMLDocument::from_node(const XMLNode& root) {
+        XMLDocument doc;
+        append_tree(doc, npos, root);
+        doc.success = true;
+        return doc;
+    }
+
+    XMLNode XMLDocument::to_node() const {
+        XMLNode node;
+        if (!nodes_.empty()) {
+            build_tree(root(), node);
+        }
+        return node;
+    }
+
+    XMLNodeRef XMLDocument::root() const {
+        return node(0);
+    }
+
+    XMLNodeRef XMLDocument::node(uint32_t index) const {
+        if (index >= nodes_.size()) {
+            return XMLNodeRef();
+        }
+        return XMLNodeRef(this, index);
+    }
+
+    std::string XMLDocument::get_value(const std::string& path, const std::string& default_value) const {
+        XMLNodeRef found = get_node(path);
+        if (found) {
+            return std::string(found.value());
+        }
+        return default_value;
+    }
+
+    std::string XMLDocument::get_attribute(const std::string& path, const std::string& attr_name, const std::string& default_value) const {
+        XMLNodeRef found = get_node(path);
+        if (found) {
+            return found.get_attribute(attr_name, default_value);
+        }
+        return default_value;
+    }
+
+    XMLNodeRef XMLDocument::get_node(const std::string& path) const {
+        XMLNodeRef current = root();
+        std::string_view rest(path);
+        while (current && !rest.empty()) {
+            size_t dot = rest.find('.');
+            std::string_view component = rest.substr(0, dot);
+            rest = dot == std::string_view::npos ? std::string_view() : rest.substr(dot + 1);
+            if (!component.empty()) {
+                current = find_child(current.index(), names_.find(component));
+            }
+        }
+        return current;
+    }
+
+    bool XMLDocument::has_path(const std::string& path) const {
+        return static_cast<bool>(get_node(path));
+    }
+
+    std::vector<std::string> XMLDocument::get_children(const std::string& path) const {
+        std::vector<std::string> result;
+        XMLNodeRef found = get_node(path);
+        for (XMLNodeRef child = found.first_child(); child; child = child.next_sibling()) {
+            result.emplace_back(child.name());
+        }
+        return result;
+    }
+
+    std::vector<std::string> XMLDocument::get_attributes(const std::string& path) const {
+        return get_node(path).get_attribute_names();
+    }
+
+    uint32_t XMLDocument::append_child(uint32_t parent, std::string_view name) {
+        if (parent == npos ? !nodes_.empty() : parent >= nodes_.size()) {
+            return npos;
+        }
+
+        uint32_t index = static_cast<uint32_t>(nodes_.size());
+        NodeData data;
+        data.name = names_.intern(name);
+        data.parent = parent;
+        nodes_.push_back(data);
+
+        if (parent != npos) {
+            NodeData& parent_data = nodes_[parent];
+            if (parent_data.last_child == npos) {
+                parent_data.first_child = index;
+            } else {
+                nodes_[parent_data.last_child].next_sibling = index;
+            }
+            parent_data.last_child = index;
+        }
+        return index;
+    }
+
+    void XMLDocument::set_value(uint32_t node, std::string_view value) {
+        if (node < nodes_.size()) {
+            nodes_[node].value = store(value);
+        }
+    }
+
+    void XMLDocument::set_attribute(uint32_t node, std::string_view name, std::string_view value) {
+        if (node >= nodes_.size()) {
+            return;
+        }
+
+        uint32_t name_id = names_.intern(name);
+        uint32_t existing = nodes_[node].first_attribute;
+        while (existing != npos && attributes_[existing].name != name_id) {
+            existing = attributes_[existing].next;
+        }
+        if (existing != npos) {
+            attributes_[existing].value = store(value);
+            return;
+        }
+
+        uint32_t index = static_cast<uint32_t>(attributes_.size());
+        AttributeData data;
+        data.name = name_id;
+        data.value = store(value);
+        attributes_.push_back(data);
+
+        NodeData& node_data = nodes_[node];
+        if (node_data.last_attribute == npos) {
+            node_data.first_attribute = index;
+        } else {
+            attributes_[node_data.last_attribute].next = index;
+        }
+        node_data.last_attribute = index;
+    }
+
+    void XMLDocument::set_namespace_uri(uint32_t node, std::string_view uri) {
+        if (node < nodes_.size()) {
+            nodes_[node].namespace_uri = intern_uri(uri);
+        }
+    }
+
+    void XMLDocument::set_attribute_namespace_uri(uint32_t node, std::string_view name, std::string_view uri) {
+        if (node >= nodes_.size()) {
+            return;
+        }
+        uint32_t name_id = names_.find(name);
+        for (uint32_t i = nodes_[node].first_attribute; i != npos; i = attributes_[i].next) {
+            if (attributes_[i].name == name_id) {
+                attributes_[i].namespace_uri = intern_uri(uri);
+                return;
+            }
+        }
+    }
+
+    XMLDocument XMLDocument::parse_root(XMLReader& reader) {
+        XMLReader::Event event = reader.next();
+        while (event != XMLReader::Event::StartElement && event != XMLReader::Event::Error) {
+            event = reader.next();
+        }
+        XMLDocument doc = read_element(reader);
+
+        // Read to the end so that content after the root element is rejected
+        while (doc.success && (event = reader.next()) != XMLReader::Event::EndDocument) {
+            if (event == XMLReader::Event::Error) {
+                XMLDocument failed;
+                failed.error_message = reader.error_message();
+                failed.error_location = reader.error_location();
+                return failed;
+            }
+        }
+        return doc;
+    }
+
+    XMLDocument::Span XMLDocument::store(std::string_view text) {
+        Span span;
+        span.offset = strings_.size();
+        span.length = text.size();
+        strings_.append(text.data(), text.size());
+        return span;
+    }
+
+    std::string_view XMLDocument::view(const Span& span) const {
+        return std::string_view(strings_).substr(span.offset, span.length);
+    }
+
+    const XMLDocument::AttributeData* XMLDocument::find_attribute(uint32_t node, std::string_view name) const {
+        uint32_t name_id = names_.find(name);
+        if (name_id == XMLNameTable::npos) {
+            return nullptr;
+        }
+        for (uint32_t i = nodes_[node].first_attribute; i != npos; i = attributes_[i].next) {
+            if (attributes_[i].name == name_id) {
+                return &attributes_[i];
+            }
+        }
+        return nullptr;
+    }
+
+    XMLNodeRef XMLDocument::find_child(uint32_t node, uint32_t name) const {
+        if (name == XMLNameTable::npos) {
+            return XMLNodeRef();
+        }
+        for (uint32_t child = nodes_[node].first_child; child != npos; child = nodes_[child].next_sibling) {
+            if (nodes_[child].name == name) {
+                return XMLNodeRef(this, child);
+            }
+        }
+        return XMLNodeRef();
+    }
+
+} // namespace parser
@@ -0,0 +1,359 @@
+#include "parsers/xml_json.h"
+#include "parsers/xml_scanner.h"
+#include <algorithm>
+
+namespace parser {
+
+    namespace {
+
+        XMLJSONResult make_error(const std::string& message, const ErrorLocation& location = ErrorLocation()) {
+            XMLJSONResult result;
+            result.error_message = message;
+            result.error_location = location;
+            return result;
+        }
+
+    } // namespace
+
+    XMLJSONResult XMLJSONConverter::xml_to_json(XMLReader& reader, JSONWriter& writer) const {
+        // An open element; the document itself is the first level
+        struct Level {
+            bool is_object = false;    // '{' was written for the element
+            bool group_open = false;   // The last child's value is deferred or its array open
+            bool group_is_array = false;
+            std::string last_child;
+            std::string text;
+        };
+        std::vector<Level> levels(1);
+        levels.front().is_object = true;
+        std::string key;
+
+        writer.start_object();
+        while (true) {
+            XMLReader::Event event = reader.next();
+            switch (event) {
+                case XMLReader::Event::StartElement: {
+                    Level& parent = levels.back();
+                    if (!parent.is_object) {
+                        writer.start_object();
+                        parent.is_object = true;
+                    }
+
+                    std::string_view name = reader.name();
+                    bool same_as_last = parent.group_open && parent.last_child == name;
+                    if (same_as_last && !parent.group_is_array) {
+                        if (!writer.wrap_in_array()) {
+                            return make_error("Element '" + std::string(name) +
+                                "' repeats after a first instance larger than the defer limit");
+                        }
+                        parent.group_is_array = true;
+                    } else if (!same_as_last) {
+                        if (parent.group_open) {
+                            if (parent.group_is_array) {
+                                writer.end_array();
+                            } else {
+                                writer.release();
+                            }
+                        }
+                        writer.key(name);
+                        // The root is never repeated, and holding it back would hold the whole document
+                        bool is_root = levels.size() == 1;
+                        if (!is_root && is_array_element(name)) {
+                            writer.start_array();
+                            parent.group_open = true;
+                            parent.group_is_array = true;
+                        } else if (!is_root && options_.group_repeated) {
+                            writer.defer();
+                            parent.group_open = true;
+                            parent.group_is_array = false;
+                        } else {
+                            parent.group_open = false;
+                        }
+                        parent.last_child.assign(name.data(), name.size());
+                    }
+
+                    levels.emplace_back();
+                    if (reader.attribute_count() > 0) {
+                        writer.start_object();
+                        levels.back().is_object = true;
+                        std::string& value = levels.back().text;
+                        for (size_t i = 0; i < reader.attribute_count(); ++i) {
+                            key = options_.attribute_prefix;
+                            key += reader.attribute_name(i);
+                            writer.key(key);
+                            XMLHandler::decode(reader.raw_attribute_value(i), value);
+                            writer.string(value);
+                            value.clear();
+                        }
+                    }
+                    break;
+                }
+                case XMLReader::Event::Text: {
+                    std::string& text = levels.back().text;
+                    XMLHandler::decode(reader.raw_text(), text);
+                    // Whitespace between child elements would be trimmed anyway; don't collect it
+                    if (options_.trim_text && detail::trim(text).empty()) {
+                        text.clear();
+                    }
+                    break;
+                }
+                case XMLReader::Event::CData:
+                    levels.back().text += reader.raw_text();
+                    break;
+                case XMLReader::Event::EndElement: {
+                    Level& level = levels.back();
+                    if (level.group_open) {
+                        if (level.group_is_array) {
+                            writer.end_array();
+                        } else {
+                            writer.release();
+                        }
+                    }
+                    std::string_view text = level.text;
+                    if (options_.trim_text) {
+                        text = detail::trim(text);
+                    }
+                    if (level.is_object) {
+                        if (!text.empty()) {
+                            writer.key(options_.text_key);
+                            writer.string(text);
+                        }
+                        writer.end_object();
+                    } else if (!text.empty()) {
+                        writer.string(text);
+                    } else {
+                        writer.null();
+                    }
+                    levels.pop_back();
+                    break;
+                }
+                case XMLReader::Event::EndDocument: {
+                    writer.end_object();
+                    if (!writer.flush()) {
+                        return make_error(writer.error_message());
+                    }
+                    XMLJSONResult result;
+                    result.success = true;
+                    return result;
+                }
+                case XMLReader::Event::Error:
+                    return make_error(reader.error_message(), reader.error_location());
+                default:
+                    // Comments and processing instructions have no JSON form
+                    break;
+            }
+            if (!writer.good()) {
+                return make_error(writer.error_message());
+            }
+        }
+    }
+
+    XMLJSONResult XMLJSONConverter::json_to_xml(JSONReader& reader, XMLWriter& writer) const {
+        // An open element or array of elements
+        struct Frame {
+            std::string name;     // Element name; for arrays the name of each item
+            bool has_content = false; // Text or a child was written, no more attributes
+        };
+        std::vector<Frame> frames;
+        std::string name;
+        bool root_written = false;
+
+        auto fail = [&](const std::string& message) {
+            reader.report_error(message);
+            return make_error(reader.error_message(), reader.error_location());
+        };
+
+        if (reader.next() != JSONReader::Event::StartObject) {
+            if (reader.event() == JSONReader::Event::Error) {
+                return make_error(reader.error_message(), reader.error_location());
+            }
+            return fail("Top-level JSON value must be an object");
+        }
+
+        while (true) {
+            JSONReader::Event event = reader.next();
+            if (event == JSONReader::Event::Error) {
+                return make_error(reader.error_message(), reader.error_location());
+            }
+
+            // Directly inside the top-level object: the root element's key
+            if (frames.empty()) {
+                if (event == JSONReader::Event::EndObject) {
+                    if (!root_written) {
+                        return fail("Top-level object must have one member, the root element");
+                    }
+                    if (reader.next() == JSONReader::Event::Error) {
+                        return make_error(reader.error_message(), reader.error_location());
+                    }
+                    break;
+                }
+                if (root_written) {
+                    return fail("Top-level object must have one member, the root element");
+                }
+                if (!detail::is_name(reader.value())) {
+                    return fail("Invalid element name");
+                }
+                name.assign(reader.value().data(), reader.value().size());
+                root_written = true;
+                event = reader.next();
+                if (event == JSONReader::Event::Error) {
+                    return make_error(reader.error_message(), reader.error_location());
+                }
+                if (event == JSONReader::Event::StartArray) {
+                    return fail("Root element cannot be an array");
+                }
+            } else if (event == JSONReader::Event::Key) {
+                // A member of an element's object
+                Frame& frame = frames.back();
+                std::string_view key = reader.value();
+                std::string_view prefix = options_.attribute_prefix;
+                if (!prefix.empty() && key.compare(0, prefix.size(), prefix) == 0) {
+                    if (frame.has_content) {
+                        return fail("Attribute member after element content");
+                    }
+                    std::string_view attr_name = key.substr(prefix.size());
+                    if (!detail::is_name(attr_name)) {
+                        return fail("Invalid attribute name");
+                    }
+                    name.assign(attr_name.data(), attr_name.size());
+                    event = reader.next();
+                    if (event == JSONReader::Event::String || event == JSONReader::Event::Number ||
+                        event == JSONReader::Event::Boolean) {
+                        writer.attribute(name, reader.value());
+                    } else if (event == JSONReader::Event::Error) {
+                        return make_error(reader.error_message(), reader.error_location());
+                    } else if (event != JSONReader::Event::Null) {
+                        return fail("Attribute value must be a string, number, boolean or null");
+                    }
+                    continue;
+                }
+
+                frame.has_content = true;
+                if (key == options_.text_key) {
+                    event = reader.next();
+                    if (event == JSONReader::Event::String || event == JSONReader::Event::Number ||
+                        event == JSONReader::Event::Boolean) {
+                        writer.text(reader.value());
+                    } else if (event == JSONReader::Event::Error) {
+                        return make_error(reader.error_message(), reader.error_location());
+                    } else if (event != JSONReader::Event::Null) {
+                        return fail("Text member must be a string, number, boolean or null");
+                    }
+                    continue;
+                }
+
+                if (!detail::is_name(key)) {
+                    return fail("Invalid element name");
+                }
+                name.assign(key.data(), key.size());
+                event = reader.next();
+                if (event == JSONReader::Event::Error) {
+                    return make_error(reader.error_message(), reader.error_location());
+                }
+            } else if (event == JSONReader::Event::EndObject) {
+                writer.end_element();
+                frames.pop_back();
+                continue;
+            } else if (event == JSONReader::Event::EndArray) {
+                frames.pop_back();
+                continue;
+            } else {
+                // An item of an array of elements
+                name = frames.back().name;
+                if (event == JSONReader::Event::StartArray) {
+                    return fail("Nested arrays have no XML form");
+                }
+            }
+
+            // A value for the element called name
+            switch (event) {
+                case JSONReader::Event::StartObject:
+                    writer.start_element(name);
+                    frames.push_back(Frame{name, false});
+                    break;
+                case JSONReader::Event::StartArray:
+                    frames.push_back(Frame{name, false});
+                    break;
+                case JSONReader::Event::String:
+                case JSONReader::Event::Number:
+                case JSONReader::Event::Boolean:
+                    writer.start_element(name);
+                    writer.text(reader.value());
+                    writer.end_element();
+                    break;
+                case JSONReader::Event::Null:
+                    writer.start_element(name);
+                    writer.end_element();
+                    break;
+                default:
+                    return fail("Unexpected JSON value");
+            }
+            if (!writer.good()) {
+                return make_error(writer.error_message());
+            }
+        }
+
+        if (!writer.flush()) {
+            return make_error(writer.error_message());
+        }
+        XMLJSONResult result;
+        result.success = true;
+        return result;
+    }
+
+    XMLJSONResult XMLJSONConverter::xml_to_json(std::string_view xml, std::string& json) const {
+        XMLReader reader;
+        reader.open_buffer(xml);
+        JSONWriter writer;
+        writer.open_buffer(json);
+        return xml_to_json(reader, writer);
+    }
+
+    XMLJSONResult XMLJSONConverter::json_to_xml(std::string_view json, std::string& xml) const {
+        JSONReader reader;
+        reader.open_buffer(json);
+        XMLWriter writer;
+        writer.open_buffer(xml);
+        return json_to_xml(reader, writer);
+    }
+
+    XMLJSONResult XMLJSONConverter::xml_file_to_json(const std::string& xml_filename, const std::string& json_filename) const {
+        XMLReader reader;
+        if (!reader.open(xml_filename)) {
+            return make_error(reader.error_message());
+        }
+        JSONWriter writer;
+        if (!writer.open(json_filename)) {
+            return make_error("Cannot create file: " + json_filename);
+        }
+        XMLJSONResult result = xml_to_json(reader, writer);
+        if (!writer.close() && result.success) {
+            return make_error(writer.error_message());
+        }
+        return result;
+    }
+
+    XMLJSONResult XMLJSONConverter::json_file_to_xml(const std::string& json_filename, const std::string& xml_filename) const {
+        JSONReader reader;
+        if (!reader.open(json_filename)) {
+            return make_error(reader.error_message());
+        }
+        XMLWriter writer;
+        if (!writer.open(xml_filename)) {
+            return make_error("Cannot create file: " + xml_filename);
+        }
+        writer.declaration();
+        XMLJSONResult result = json_to_xml(reader, writer);
+        if (!writer.close() && result.success) {
+            return make_error(writer.error_message());
+        }
+        return result;
+    }
+
+    // Private helper methods
+    bool XMLJSONConverter::is_array_element(std::string_view name) const {
+        return std::find(options_.array_elements.begin(), options_.array_elements.end(), name) !=
+               options_.array_elements.end();
+    }
+
+} // namespace parser
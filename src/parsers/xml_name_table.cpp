@@ -0,0 +1,73 @@
+#include "parsers/xml_name_table.h"
+#include <functional>
+
+namespace parser {
+
+    namespace {
+
+        constexpr size_t kInitialSlots = 64;
+
+    } // namespace
+
+    uint32_t XMLNameTable::intern(std::string_view name) {
+        // Keep the table at most half full so probe sequences stay short
+        if ((entries_.size() + 1) * 2 > slots_.size()) {
+            grow();
+        }
+
+        size_t hash = std::hash<std::string_view>()(name);
+        size_t slot = probe(name, hash);
+        if (slots_[slot] != npos) {
+            return slots_[slot];
+        }
+
+        uint32_t id = static_cast<uint32_t>(entries_.size());
+        entries_.push_back(Entry{pool_.size(), name.size(), hash});
+        pool_.append(name.data(), name.size());
+        slots_[slot] = id;
+        return id;
+    }
+
+    uint32_t XMLNameTable::find(std::string_view name) const {
+        if (slots_.empty()) {
+            return npos;
+        }
+        return slots_[probe(name, std::hash<std::string_view>()(name))];
+    }
+
+    std::string_view XMLNameTable::name(uint32_t id) const {
+        if (id >= entries_.size()) {
+            return std::string_view();
+        }
+        const Entry& entry = entries_[id];
+        return std::string_view(pool_).substr(entry.offset, entry.length);
+    }
+
+    size_t XMLNameTable::probe(std::string_view name, size_t hash) const {
+        size_t mask = slots_.size() - 1;
+        for (size_t slot = hash & mask;; slot = (slot + 1) & mask) {
+            uint32_t id = slots_[slot];
+            if (id == npos) {
+                return slot;
+            }
+            const Entry& entry = entries_[id];
+            if (entry.hash == hash && std::string_view(pool_).substr(entry.offset, entry.length) == name) {
+                return slot;
+            }
+        }
+    }
+
+    void XMLNameTable::grow() {
+        size_t capacity = slots_.empty() ? kInitialSlots : slots_.size() * 2;
+        slots_.assign(capacity, npos);
+        size_t mask = capacity - 1;
+        for (uint32_t id = 0; id < entries_.size(); ++id) {
+            size_t slot = entries_[id].hash & mask;
+            while (slots_[slot] != npos) {
+                slot = (slot + 1) & mask;
+            }
+            slots_[slot] = id;
+        }
+    }
+
+} // namespace parser
@@ -0,0 +1,87 @@
+#include "parsers/xml_namespaces.h"
+
+namespace parser {
+
+    XMLNamespaceScope::XMLNamespaceScope() {
+        clear();
+    }
+
+    void XMLNamespaceScope::clear() {
+        bindings_.clear();
+        scopes_.clear();
+        bindings_.push_back(Binding{"xml", uris_.intern(kXMLNamespace)});
+        bindings_.push_back(Binding{"xmlns", uris_.intern(kXMLNSNamespace)});
+    }
+
+    void XMLNamespaceScope::push() {
+        scopes_.push_back(bindings_.size());
+    }
+
+    void XMLNamespaceScope::pop() {
+        if (scopes_.empty()) {
+            return;
+        }
+        bindings_.resize(scopes_.back());
+        scopes_.pop_back();
+    }
+
+    const char* XMLNamespaceScope::bind(std::string_view prefix, std::string_view uri) {
+        if (prefix == "xmlns") {
+            return "The xmlns prefix cannot be declared";
+        }
+        if (prefix == "xml" && uri != kXMLNamespace) {
+            return "The xml prefix cannot be bound to another namespace";
+        }
+        if (uri.empty()) {
+            if (!prefix.empty()) {
+                return "Empty namespace URI for prefix";
+            }
+            bindings_.push_back(Binding{std::string(), npos});
+            return nullptr;
+        }
+        bindings_.push_back(Binding{std::string(prefix), uris_.intern(uri)});
+        return nullptr;
+    }
+
+    bool XMLNamespaceScope::resolve(std::string_view prefix, uint32_t& uri) const {
+        // Innermost declarations are at the back
+        for (size_t i = bindings_.size(); i-- > 0;) {
+            if (bindings_[i].prefix == prefix) {
+                uri = bindings_[i].uri;
+                return true;
+            }
+        }
+        uri = npos;
+        return prefix.empty();
+    }
+
+    std::string_view XMLNamespaceScope::uri(uint32_t id) const {
+        return uris_.name(id);
+    }
+
+    std::string_view XMLNamespaceScope::prefix(std::string_view qname) {
+        size_t colon = qname.find(':');
+        return colon == std::string_view::npos ? std::string_view() : qname.substr(0, colon);
+    }
+
+    std::string_view XMLNamespaceScope::local_name(std::string_view qname) {
+        size_t colon = qname.find(':');
+        return colon == std::string_view::npos ? qname : qname.substr(colon + 1);
+    }
+
+    bool XMLNamespaceScope::is_declaration(std::string_view attr_name, std::string_view& prefix) {
+        if (attr_name.compare(0, 5, "xmlns") != 0) {
+            return false;
+        }
+        if (attr_name.size() == 5) {
+            prefix = std::string_view();
+            return true;
+        }
+        if (attr_name[5] != ':') {
+            return false;
+        }
+        prefix = attr_name.substr(6);
+        return true;
+    }
+
+} // namespace parser
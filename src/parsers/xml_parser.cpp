@@ -1,14 +1,430 @@
 #include "parsers/xml_parser.h"
+#include "parsers/xml_scanner.h"
+#include "parsers/xml_writer.h"
 #include <fstream>
 #include <sstream>
 #include <algorithm>
-#include <cctype>
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <thread>
 
 namespace parser {
 
+    namespace {
+
+        // Smallest chunk worth handing to its own thread
+        constexpr size_t kParallelMinChunk = 64 * 1024;
+
+        // Chunk size for parse_records, which bounds the records held at once
+        constexpr size_t kRecordChunk = 4 * 1024 * 1024;
+
+        // Arena block size; larger requests get their own allocation
+        // from a sixteenth of it on
+        constexpr size_t kArenaBlock = 64 * 1024;
+
+        /**
+         * Structural pre-scan of the root element's content starting at begin.
+         * Fills splits with the positions that bound each chunk: begin, the
+         * '<' of a top-level start tag near every chunk_size bytes, and the
+         * '<' of the root's closing tag. Comments, CDATA sections, processing
+         * instructions and quoted attribute values are skipped whole. Returns
+         * false on malformed structure.
+         */
+        bool find_split_points(const std::string& content, size_t begin, size_t chunk_size, std::vector<size_t>& splits) {
+            const char* data = content.data();
+            size_t length = content.length();
+            size_t depth = 0;
+            size_t next_split = begin + chunk_size;
+            splits.push_back(begin);
+
+            for (size_t pos = begin;;) {
+                const void* open = std::memchr(data + pos, '<', length - pos);
+                if (!open) {
+                    return false;
+                }
+                pos = static_cast<const char*>(open) - data;
+                if (pos + 1 >= length) {
+                    return false;
+                }
+
+                const char* terminator = nullptr;
+                size_t skip = 0;
+                if (content.compare(pos, 4, "<!--") == 0) {
+                    terminator = "-->";
+                    skip = 4;
+                } else if (content.compare(pos, 9, "<![CDATA[") == 0) {
+                    terminator = "]]>";
+                    skip = 9;
+                } else if (data[pos + 1] == '?') {
+                    terminator = "?>";
+                    skip = 2;
+                } else if (data[pos + 1] == '!') {
+                    return false;
+                }
+                if (terminator) {
+                    size_t end_pos = content.find(terminator, pos + skip);
+                    if (end_pos == std::string::npos) {
+                        return false;
+                    }
+                    pos = end_pos + std::strlen(terminator);
+                    continue;
+                }
+
+                if (data[pos + 1] == '/') {
+                    if (depth == 0) {
+                        splits.push_back(pos);
+                        return true;
+                    }
+                    depth--;
+                    size_t tag_end = content.find('>', pos + 2);
+                    if (tag_end == std::string::npos) {
+                        return false;
+                    }
+                    pos = tag_end + 1;
+                    continue;
+                }
+
+                if (depth == 0 && pos >= next_split) {
+                    splits.push_back(pos);
+                    next_split = pos + chunk_size;
+                }
+                // Find the end of the start tag; '>' may appear in quoted values
+                size_t scan = pos + 1;
+                while (true) {
+                    size_t stop = content.find_first_of("\"'>", scan);
+                    if (stop == std::string::npos) {
+                        return false;
+                    }
+                    if (data[stop] == '>') {
+                        if (data[stop - 1] != '/') {
+                            depth++;
+                        }
+                        pos = stop + 1;
+                        break;
+                    }
+                    size_t quote_end = content.find(data[stop], stop + 1);
+                    if (quote_end == std::string::npos) {
+                        return false;
+                    }
+                    scan = quote_end + 1;
+                }
+            }
+        }
+
+        // Strings shared between nodes come from the nodes' own memory
+        // resource, so a tree in an arena never points outside it
+        std::shared_ptr<const std::pmr::string> make_shared_string(std::string_view text, const XMLNode::allocator_type& alloc) {
+            // The allocator hands itself to the string it constructs
+            return std::allocate_shared<std::pmr::string>(alloc, text);
+        }
+
+        std::shared_ptr<const std::pmr::string> share_string(const std::shared_ptr<const std::pmr::string>& shared,
+                                                             const XMLNode::allocator_type& from,
+                                                             const XMLNode::allocator_type& to) {
+            if (!shared || from == to) {
+                return shared;
+            }
+            return make_shared_string(*shared, to);
+        }
+
+        class HeapResource : public std::pmr::memory_resource {
+            void* do_allocate(size_t bytes, size_t alignment) override {
+                if (alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+                    return ::operator new(bytes);
+                }
+                return ::operator new(bytes, std::align_val_t(alignment));
+            }
+
+            void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+                if (alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+                    ::operator delete(p, bytes);
+                } else {
+                    ::operator delete(p, bytes, std::align_val_t(alignment));
+                }
+            }
+
+            bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+                return this == &other;
+            }
+        };
+
+    } // namespace
+
+    std::pmr::memory_resource* xml_heap_resource() {
+        static HeapResource resource;
+        return &resource;
+    }
+
+    // XMLAttribute implementation
+    XMLAttribute::XMLAttribute(const XMLAttribute& other)
+        : XMLAttribute(other, allocator_type(xml_heap_resource())) {
+    }
+
+    XMLAttribute::XMLAttribute(const XMLAttribute& other, const allocator_type& alloc)
+        : name(other.name, alloc),
+          value(other.value, alloc),
+          namespace_(share_string(other.namespace_, other.name.get_allocator(), alloc)),
+          sorted_(other.sorted_) {
+    }
+
+    void XMLAttribute::rehome_namespace() {
+        namespace_ = make_shared_string(*namespace_, name.get_allocator());
+    }
+
+    XMLAttribute& XMLAttribute::operator=(const XMLAttribute& other) {
+        name = other.name;
+        value = other.value;
+        namespace_ = share_string(other.namespace_, other.name.get_allocator(), name.get_allocator());
+        sorted_ = other.sorted_;
+        return *this;
+    }
+
+    XMLAttribute& XMLAttribute::operator=(XMLAttribute&& other) {
+        if (other.name.get_allocator() == name.get_allocator()) {
+            namespace_ = std::move(other.namespace_);
+        } else {
+            namespace_ = share_string(other.namespace_, other.name.get_allocator(), name.get_allocator());
+        }
+        name = std::move(other.name);
+        value = std::move(other.value);
+        sorted_ = other.sorted_;
+        return *this;
+    }
+
+    // XMLAttributes implementation
+    void XMLAttributes::clear() {
+        items_.clear();
+    }
+
+    XMLAttributes::const_iterator XMLAttributes::find(std::string_view name) const {
+        if (items_.size() <= kIndexThreshold) {
+            return std::find_if(items_.begin(), items_.end(), [name](const XMLAttribute& attr) {
+                return attr.name == name;
+            });
+        }
+        size_t place = lower_bound(name, items_.size());
+        if (place < items_.size() && items_[items_[place].sorted_].name == name) {
+            return items_.begin() + items_[place].sorted_;
+        }
+        return items_.end();
+    }
+
+    std::pmr::string& XMLAttributes::operator[](std::string_view name) {
+        const_iterator existing = find(name);
+        if (existing != items_.end()) {
+            return items_[existing - items_.begin()].value;
+        }
+
+        uint32_t position = static_cast<uint32_t>(items_.size());
+        items_.emplace_back(name, std::string_view());
+        if (position > kIndexThreshold) {
+            // Shift the name order up by one from the new name's place
+            size_t place = lower_bound(name, position);
+            for (size_t i = position; i > place; --i) {
+                items_[i].sorted_ = items_[i - 1].sorted_;
+            }
+            items_[place].sorted_ = position;
+        } else if (items_.size() > kIndexThreshold) {
+            rebuild_index();
+        }
+        return items_.back().value;
+    }
+
+    size_t XMLAttributes::erase(std::string_view name) {
+        const_iterator existing = find(name);
+        if (existing == items_.end()) {
+            return 0;
+        }
+        items_.erase(existing);
+        rebuild_index();
+        return 1;
+    }
+
+    size_t XMLAttributes::lower_bound(std::string_view name, size_t count) const {
+        size_t low = 0;
+        size_t high = count;
+        while (low < high) {
+            size_t middle = low + (high - low) / 2;
+            if (items_[items_[middle].sorted_].name < name) {
+                low = middle + 1;
+            } else {
+                high = middle;
+            }
+        }
+        return low;
+    }
+
+    void XMLAttributes::rebuild_index() {
+        if (items_.size() <= kIndexThreshold) {
+            return;
+        }
+        std::vector<uint32_t> order(items_.size());
+        for (size_t i = 0; i < order.size(); ++i) {
+            order[i] = static_cast<uint32_t>(i);
+        }
+        std::sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b) {
+            return items_[a].name < items_[b].name;
+        });
+        for (size_t i = 0; i < order.size(); ++i) {
+            items_[i].sorted_ = order[i];
+        }
+    }
+
     // XMLNode implementation
-    XMLNode* XMLNode::get_child(const std::string& child_name) {
+    XMLNode::XMLNode(const allocator_type& alloc)
+        : name(alloc),
+          value(alloc),
+          attributes(alloc),
+          children(alloc) {
+    }
+
+    XMLNode::XMLNode(const XMLNode& other)
+        : XMLNode(other, allocator_type(xml_heap_resource())) {
+    }
+
+    XMLNode::XMLNode(const XMLNode& other, const allocator_type& alloc)
+        : type(other.type),
+          name(other.name, alloc),
+          value(other.value, alloc),
+          attributes(other.attributes, alloc),
+          children(alloc),
+          parent(other.parent) {
+        copy_shared(other);
+        copy_children(other);
+    }
+
+    XMLNode::XMLNode(XMLNode&& other) noexcept
+        : type(other.type),
+          name(std::move(other.name)),
+          value(std::move(other.value)),
+          attributes(std::move(other.attributes)),
+          children(std::move(other.children)),
+          parent(other.parent),
+          namespace_(std::move(other.namespace_)),
+          source_(std::move(other.source_)),
+          raw_offset_(other.raw_offset_),
+          raw_length_(other.raw_length_) {
+        relink_children();
+    }
+
+    XMLNode::XMLNode(XMLNode&& other, const allocator_type& alloc)
+        : type(other.type),
+          name(std::move(other.name), alloc),
+          value(std::move(other.value), alloc),
+          attributes(std::move(other.attributes), alloc),
+          children(alloc),
+          parent(other.parent) {
+        if (other.get_allocator() == alloc) {
+            namespace_ = std::move(other.namespace_);
+            source_ = std::move(other.source_);
+            raw_offset_ = other.raw_offset_;
+            raw_length_ = other.raw_length_;
+            children = std::move(other.children);
+            relink_children();
+        } else {
+            // The subtree moves to another memory resource by copying, which needs no recursion
+            copy_shared(other);
+            copy_children(other);
+        }
+    }
+
+    XMLNode::~XMLNode() {
+        if (children.empty()) {
+            return;
+        }
+
+        // Depth-first with an explicit stack: a node is only destroyed
+        // once its children have been moved out and freed
+        std::vector<std::pmr::vector<XMLNode>> stack;
+        stack.push_back(std::move(children));
+        while (!stack.empty()) {
+            std::pmr::vector<XMLNode>& nodes = stack.back();
+            if (nodes.empty()) {
+                stack.pop_back();
+            } else if (nodes.back().children.empty()) {
+                nodes.pop_back();
+            } else {
+                std::pmr::vector<XMLNode> grandchildren = std::move(nodes.back().children);
+                stack.push_back(std::move(grandchildren));
+            }
+        }
+    }
+
+    XMLNode& XMLNode::operator=(const XMLNode& other) {
+        if (this != &other) {
+            *this = XMLNode(other);
+        }
+        return *this;
+    }
+
+    XMLNode& XMLNode::operator=(XMLNode&& other) noexcept {
+        if (this != &other) {
+            // Detach first: other may live inside this node's subtree
+            XMLNode detached(std::move(other));
+            type = detached.type;
+            name = std::move(detached.name);
+            value = std::move(detached.value);
+            attributes = std::move(detached.attributes);
+            children = std::move(detached.children);
+            copy_shared(detached);
+            relink_children();
+        }
+        return *this;
+    }
+
+    void XMLNode::copy_children(const XMLNode& other) {
+        struct Frame {
+            const XMLNode* source;
+            XMLNode* copy;
+        };
+        // Explicit stack, so deep trees cannot exhaust the call stack
+        std::vector<Frame> stack;
+        stack.push_back(Frame{&other, this});
+        while (!stack.empty()) {
+            Frame frame = stack.back();
+            stack.pop_back();
+            // Reserved up front, so the copies stay put while their own children are copied
+            frame.copy->children.reserve(frame.source->children.size());
+            for (const XMLNode& child : frame.source->children) {
+                XMLNode& copy = frame.copy->children.emplace_back();
+                copy.type = child.type;
+                copy.name = child.name;
+                copy.value = child.value;
+                copy.attributes = child.attributes;
+                copy.parent = frame.copy;
+                copy.copy_shared(child);
+                stack.push_back(Frame{&child, &copy});
+            }
+        }
+    }
+
+    void XMLNode::copy_shared(const XMLNode& other) {
+        namespace_ = share_string(other.namespace_, other.get_allocator(), get_allocator());
+        if (!other.source_ || other.get_allocator() == get_allocator()) {
+            source_ = other.source_;
+            raw_offset_ = other.raw_offset_;
+        } else {
+            // Only the span this node uses is copied
+            source_ = make_shared_string(other.raw(), get_allocator());
+            raw_offset_ = 0;
+        }
+        raw_length_ = other.raw_length_;
+    }
+
+    void XMLNode::relink_children() {
         for (auto& child : children) {
+            child.parent = this;
+        }
+    }
+
+    XMLNode* XMLNode::get_child(std::string_view child_name) {
+        return const_cast<XMLNode*>(static_cast<const XMLNode*>(this)->get_child(child_name));
+    }
+
+    const XMLNode* XMLNode::get_child(std::string_view child_name) const {
+        for (const auto& child : children) {
             if (child.name == child_name) {
                 return &child;
             }
@@ -16,19 +432,32 @@ namespace parser {
         return nullptr;
     }
 
-    const XMLNode* XMLNode::get_child(const std::string& child_name) const {
+    XMLNode* XMLNode::get_child_ns(std::string_view namespace_uri, std::string_view local_name) {
+        return const_cast<XMLNode*>(static_cast<const XMLNode*>(this)->get_child_ns(namespace_uri, local_name));
+    }
+
+    const XMLNode* XMLNode::get_child_ns(std::string_view namespace_uri, std::string_view local_name) const {
         for (const auto& child : children) {
-            if (child.name == child_name) {
+            if (child.is_element() && child.local_name() == local_name && child.namespace_uri() == namespace_uri) {
                 return &child;
             }
         }
         return nullptr;
     }
 
+    std::string XMLNode::get_attribute_ns(std::string_view namespace_uri, std::string_view local_name, const std::string& default_value) const {
+        for (const auto& attr : attributes) {
+            if (attr.local_name() == local_name && attr.namespace_uri() == namespace_uri) {
+                return std::string(attr.value);
+            }
+        }
+        return default_value;
+    }
+
     std::string XMLNode::get_attribute(const std::string& attr_name, const std::string& default_value) const {
         auto it = attributes.find(attr_name);
         if (it != attributes.end()) {
-            return it->second;
+            return std::string(it->value);
         }
         return default_value;
     }
@@ -40,7 +469,7 @@ namespace parser {
     std::vector<XMLNode*> XMLNode::get_children(const std::string& child_name) {
         std::vector<XMLNode*> result;
         for (auto& child : children) {
-            if (child.name == child_name) {
+            if (child.name == std::string_view(child_name)) {
                 result.push_back(&child);
             }
         }
@@ -50,27 +479,339 @@ namespace parser {
     std::vector<const XMLNode*> XMLNode::get_children(const std::string& child_name) const {
         std::vector<const XMLNode*> result;
         for (const auto& child : children) {
-            if (child.name == child_name) {
+            if (child.name == std::string_view(child_name)) {
                 result.push_back(&child);
             }
         }
         return result;
     }
 
-    void XMLNode::add_child(const XMLNode& child) {
-        children.push_back(child);
+    XMLNode& XMLNode::add_child(const XMLNode& child) {
+        return add_child(XMLNode(child));
+    }
+
+    XMLNode& XMLNode::add_child(XMLNode&& child) {
+        children.push_back(std::move(child));
         children.back().parent = this;
+        return children.back();
     }
 
     void XMLNode::set_attribute(const std::string& name, const std::string& value) {
         attributes[name] = value;
     }
 
+    XMLNode XMLNode::make_content(Type type, std::string_view raw) {
+        XMLNode node;
+        node.type = type;
+        node.source_ = make_shared_string(raw, node.get_allocator());
+        node.raw_length_ = raw.size();
+        return node;
+    }
+
+    std::string_view XMLNode::raw() const {
+        if (!source_) {
+            return std::string_view();
+        }
+        return std::string_view(*source_).substr(raw_offset_, raw_length_);
+    }
+
+    std::string XMLNode::text() const {
+        if (type != Type::Text) {
+            return std::string(raw());
+        }
+        std::string result;
+        detail::decode_entities(raw(), result);
+        return result;
+    }
+
     // XMLResult implementation
+
+    // Memory of released arenas, which the parser hands to its next parse:
+    // all of their blocks, and their most recent large allocations
+    struct XMLResult::ArenaBlocks {
+        struct Block {
+            Block* next;
+        };
+
+        struct Large {
+            Large* prev;
+            Large* next;
+            size_t size;
+            size_t alignment;
+        };
+
+        // Spare large allocations kept at most
+        static constexpr size_t kSpareLarges = 32;
+
+        ArenaBlocks() = default;
+        ArenaBlocks(const ArenaBlocks&) = delete;
+        ArenaBlocks& operator=(const ArenaBlocks&) = delete;
+
+        ~ArenaBlocks() {
+            while (spare) {
+                Block* next = spare->next;
+                ::operator delete(spare, kArenaBlock);
+                spare = next;
+            }
+            while (spare_large) {
+                Large* next = spare_large->next;
+                release(spare_large);
+                spare_large = next;
+            }
+        }
+
+        static size_t round_up(size_t size, size_t alignment) {
+            return (size + alignment - 1) / alignment * alignment;
+        }
+
+        static size_t large_alignment(size_t alignment) {
+            return std::max(alignment, alignof(std::max_align_t));
+        }
+
+        // Distance from a large allocation's header to its memory
+        static size_t large_offset(size_t alignment) {
+            return round_up(sizeof(Large), large_alignment(alignment));
+        }
+
+        static void release(Large* large) {
+            xml_heap_resource()->deallocate(large, large_offset(large->alignment) + large->size,
+                                            large_alignment(large->alignment));
+        }
+
+        Block* take() {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (spare) {
+                    Block* block = spare;
+                    spare = block->next;
+                    return block;
+                }
+            }
+            return static_cast<Block*>(::operator new(kArenaBlock));
+        }
+
+        // Take back a chain of blocks in one step
+        void give(Block* newest, Block* oldest) {
+            std::lock_guard<std::mutex> lock(mutex);
+            oldest->next = spare;
+            spare = newest;
+        }
+
+        // The smallest spare that fits without wasting more than a quarter of
+        // it; vectors and strings grow by doubling, so an earlier parse of a
+        // similar document left one of just the right size
+        Large* take_large(size_t bytes, size_t alignment) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                Large** best = nullptr;
+                for (Large** link = &spare_large; *link; link = &(*link)->next) {
+                    Large* large = *link;
+                    if (large->alignment == alignment && large->size >= bytes && large->size <= bytes + bytes / 4 &&
+                        (!best || large->size < (*best)->size)) {
+                        best = link;
+                    }
+                }
+                if (best) {
+                    Large* large = *best;
+                    *best = large->next;
+                    --spare_large_count;
+                    return large;
+                }
+            }
+            Large* large = static_cast<Large*>(xml_heap_resource()->allocate(large_offset(alignment) + bytes,
+                                                                             large_alignment(alignment)));
+            large->size = bytes;
+            large->alignment = alignment;
+            return large;
+        }
+
+        void give_large(Large* large) {
+            Large* oldest = nullptr;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                large->next = spare_large;
+                spare_large = large;
+                if (++spare_large_count > kSpareLarges) {
+                    Large* last = spare_large;
+                    while (last->next->next) {
+                        last = last->next;
+                    }
+                    oldest = last->next;
+                    last->next = nullptr;
+                    --spare_large_count;
+                }
+            }
+            if (oldest) {
+                release(oldest);
+            }
+        }
+
+        std::mutex mutex;
+        Block* spare = nullptr;
+        Large* spare_large = nullptr; // Most recently given first
+        size_t spare_large_count = 0;
+    };
+
+    // Small requests are carved from blocks and only returned with the arena.
+    // Large ones, such as the child list of a long run of siblings, are
+    // allocated on their own and given back when the tree lets go of them,
+    // so a growing vector leaves no dead copies in the arena.
+    struct XMLResult::Arena : std::pmr::memory_resource {
+        explicit Arena(std::shared_ptr<ArenaBlocks> blocks) : blocks_(std::move(blocks)) {}
+
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+
+        ~Arena() override {
+            if (oldest_) {
+                blocks_->give(current_, oldest_);
+            }
+            while (large_) {
+                Large* next = large_->next;
+                blocks_->give_large(large_);
+                large_ = next;
+            }
+        }
+
+    private:
+        using Block = ArenaBlocks::Block;
+        using Large = ArenaBlocks::Large;
+
+        static constexpr size_t kLargeRequest = kArenaBlock / 16;
+
+        static bool is_large(size_t bytes, size_t alignment) {
+            return bytes > kLargeRequest || alignment > alignof(std::max_align_t);
+        }
+
+        void* do_allocate(size_t bytes, size_t alignment) override {
+            if (is_large(bytes, alignment)) {
+                Large* large = blocks_->take_large(bytes, alignment);
+                large->prev = nullptr;
+                large->next = large_;
+                if (large_) {
+                    large_->prev = large;
+                }
+                large_ = large;
+                return reinterpret_cast<char*>(large) + ArenaBlocks::large_offset(alignment);
+            }
+            size_t start = ArenaBlocks::round_up(used_, alignment);
+            if (!current_ || start + bytes > kArenaBlock) {
+                Block* block = blocks_->take();
+                block->next = current_;
+                current_ = block;
+                if (!oldest_) {
+                    oldest_ = block;
+                }
+                start = ArenaBlocks::round_up(sizeof(Block), alignof(std::max_align_t));
+            }
+            used_ = start + bytes;
+            return reinterpret_cast<char*>(current_) + start;
+        }
+
+        void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+            if (!is_large(bytes, alignment)) {
+                return;
+            }
+            Large* large = reinterpret_cast<Large*>(static_cast<char*>(p) - ArenaBlocks::large_offset(alignment));
+            if (large->prev) {
+                large->prev->next = large->next;
+            } else {
+                large_ = large->next;
+            }
+            if (large->next) {
+                large->next->prev = large->prev;
+            }
+            blocks_->give_large(large);
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+
+        std::shared_ptr<ArenaBlocks> blocks_;
+        Block* current_ = nullptr; // Newest block, linked to the older ones
+        Block* oldest_ = nullptr;
+        size_t used_ = 0;
+        Large* large_ = nullptr;
+    };
+
+    uint64_t XMLResult::next_generation() {
+        static std::atomic<uint64_t> last{0};
+        return last.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    XMLResult::XMLResult() = default;
+
+    XMLResult::XMLResult(std::shared_ptr<ArenaBlocks> blocks)
+        : arena_(std::make_unique<Arena>(std::move(blocks))),
+          root(XMLNode::allocator_type(arena_.get())) {
+    }
+
+    XMLResult::XMLResult(XMLResult&& other) noexcept
+        : success(other.success),
+          error_message(std::move(other.error_message)),
+          error_location(other.error_location),
+          arena_(std::move(other.arena_)),
+          root(std::move(other.root)) {
+        if (arena_) {
+            // What the moved-from root still shares lives in the arena now owned here
+            new (&other.root) XMLNode();
+        }
+        other.generation_ = next_generation();
+    }
+
+    XMLResult::~XMLResult() {
+        release_tree();
+    }
+
+    void XMLResult::release_tree() {
+        if (arena_) {
+            // Everything the tree owns is in the arena, so reusing root's
+            // storage for an empty node ends the tree without destroying
+            // node by node; the arena then frees its blocks at once
+            new (&root) XMLNode();
+        }
+    }
+
+    XMLResult::XMLResult(const XMLResult& other)
+        : success(other.success),
+          error_message(other.error_message),
+          error_location(other.error_location),
+          root(other.root) {
+    }
+
+    XMLResult& XMLResult::operator=(const XMLResult& other) {
+        if (this != &other) {
+            *this = XMLResult(other);
+        }
+        return *this;
+    }
+
+    XMLResult& XMLResult::operator=(XMLResult&& other) noexcept {
+        if (this != &other) {
+            success = other.success;
+            error_message = std::move(other.error_message);
+            error_location = other.error_location;
+            // A node keeps its memory resource when assigned to, so root is
+            // rebuilt to take over the other tree along with its arena
+            release_tree();
+            root.~XMLNode();
+            arena_ = std::move(other.arena_);
+            new (&root) XMLNode(std::move(other.root));
+            if (arena_) {
+                new (&other.root) XMLNode();
+            }
+            // Both trees changed, so neither keeps entries cached for it
+            generation_ = next_generation();
+            other.generation_ = next_generation();
+        }
+        return *this;
+    }
+
     std::string XMLResult::get_value(const std::string& path, const std::string& default_value) const {
         const XMLNode* node = get_node(path);
         if (node) {
-            return node->value;
+            return std::string(node->value);
         }
         return default_value;
     }
@@ -84,32 +825,7 @@ namespace parser {
     }
 
     const XMLNode* XMLResult::get_node(const std::string& path) const {
-        if (path.empty()) {
-            return &root;
-        }
-        std::vector<std::string> components;
-        std::istringstream path_stream(path);
-        std::string component;
-        while (std::getline(path_stream, component, '.')) {
-            if (!component.empty()) {
-                components.push_back(component);
-            }
-        }
-        const XMLNode* current = &root;
-        for (const auto& comp : components) {
-            bool found = false;
-            for (size_t i = 0; i < current->children.size(); ++i) {
-                if (current->children[i].name == comp) {
-                    current = &current->children[i];
-                    found = true;
-                    break;
-                }
-            }
-            if (!found) {
-                return nullptr;
-            }
-        }
-        return current;
+        return XMLPath::resolve(root, path);
     }
 
     bool XMLResult::has_path(const std::string& path) const {
@@ -124,7 +840,9 @@ namespace parser {
         
         std::vector<std::string> result;
         for (const auto& child : node->children) {
-            result.push_back(child.name);
+            if (child.is_element()) {
+                result.emplace_back(child.name);
+            }
         }
         return result;
     }
@@ -137,41 +855,186 @@ namespace parser {
         
         std::vector<std::string> result;
         for (const auto& attr : node->attributes) {
-            result.push_back(attr.first);
+            result.emplace_back(attr.name);
+        }
+        return result;
+    }
+
+    std::string XMLResult::get_value(const XMLPath& path, const std::string& default_value) const {
+        const XMLNode* node = path.resolve(root);
+        if (node) {
+            return std::string(node->value);
+        }
+        return default_value;
+    }
+
+    std::string XMLResult::get_attribute(const XMLPath& path, const std::string& attr_name, const std::string& default_value) const {
+        const XMLNode* node = path.resolve(root);
+        if (node) {
+            return node->get_attribute(attr_name, default_value);
+        }
+        return default_value;
+    }
+
+    const XMLNode* XMLResult::get_node(const XMLPath& path) const {
+        return path.resolve(root);
+    }
+
+    bool XMLResult::has_path(const XMLPath& path) const {
+        return path.resolve(root) != nullptr;
+    }
+
+    // XMLPath implementation
+    XMLPath::XMLPath(const std::string& path) : path_(path) {
+        std::string_view rest(path);
+        while (!rest.empty()) {
+            size_t dot = rest.find('.');
+            std::string_view component = rest.substr(0, dot);
+            rest = dot == std::string_view::npos ? std::string_view() : rest.substr(dot + 1);
+            if (!component.empty()) {
+                components_.emplace_back(component);
+            }
+        }
+    }
+
+    const XMLNode* XMLPath::resolve(const XMLNode& root) const {
+        const XMLNode* current = &root;
+        for (const auto& component : components_) {
+            current = current->get_child(component);
+            if (!current) {
+                return nullptr;
+            }
         }
+        return current;
+    }
+
+    const XMLNode* XMLPath::resolve(const XMLNode& root, std::string_view path) {
+        const XMLNode* current = &root;
+        while (current && !path.empty()) {
+            size_t dot = path.find('.');
+            std::string_view component = path.substr(0, dot);
+            path = dot == std::string_view::npos ? std::string_view() : path.substr(dot + 1);
+            if (!component.empty()) {
+                current = current->get_child(component);
+            }
+        }
+        return current;
+    }
+
+    // XMLPathCache implementation
+    const XMLNode* XMLPathCache::resolve(const XMLResult& result, const std::string& path) {
+        {
+            std::shared_lock<std::shared_mutex> lock(mutex_);
+            if (generation_ == result.generation_) {
+                auto it = nodes_.find(path);
+                if (it != nodes_.end()) {
+                    return it->second;
+                }
+            }
+        }
+
+        const XMLNode* node = XMLPath::resolve(result.root, path);
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        if (generation_ != result.generation_ || nodes_.size() >= kMaxEntries) {
+            nodes_.clear();
+            generation_ = result.generation_;
+        }
+        nodes_.emplace(path, node);
+        return node;
+    }
+
+    void XMLPathCache::clear() {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        nodes_.clear();
+        generation_ = 0;
+    }
+
+    // XMLChildIndex implementation
+    XMLChildIndex::XMLChildIndex(const XMLNode& node)
+        : node_(&node), data_(node.children.data()), size_(node.children.size()) {
+        std::hash<std::string_view> hasher;
+        entries_.reserve(size_);
+        for (size_t i = 0; i < size_; ++i) {
+            entries_.emplace_back(hasher(node.children[i].name), i);
+        }
+        std::sort(entries_.begin(), entries_.end());
+    }
+
+    template <typename Visitor>
+    void XMLChildIndex::visit_named(std::string_view child_name, Visitor&& visit) const {
+        const auto& children = node_->children;
+        if (children.data() != data_ || children.size() != size_) {
+            for (const auto& child : children) {
+                if (child.name == child_name && !visit(child)) {
+                    return;
+                }
+            }
+            return;
+        }
+
+        // Entries with equal hashes are ordered by position, i.e. document order
+        size_t hash = std::hash<std::string_view>()(child_name);
+        auto it = std::lower_bound(entries_.begin(), entries_.end(), std::make_pair(hash, size_t(0)));
+        for (; it != entries_.end() && it->first == hash; ++it) {
+            const XMLNode& child = children[it->second];
+            if (child.name == child_name && !visit(child)) {
+                return;
+            }
+        }
+    }
+
+    const XMLNode* XMLChildIndex::find(std::string_view child_name) const {
+        const XMLNode* found = nullptr;
+        visit_named(child_name, [&found](const XMLNode& child) {
+            found = &child;
+            return false;
+        });
+        return found;
+    }
+
+    std::vector<const XMLNode*> XMLChildIndex::find_all(std::string_view child_name) const {
+        std::vector<const XMLNode*> result;
+        visit_named(child_name, [&result](const XMLNode& child) {
+            result.push_back(&child);
+            return true;
+        });
+        return result;
+    }
+
+    // XMLHandler implementation
+    std::string XMLHandler::decode(std::string_view raw) {
+        std::string result;
+        detail::decode_entities(raw, result);
         return result;
     }
 
+    void XMLHandler::decode(std::string_view raw, std::string& out) {
+        detail::decode_entities(raw, out);
+    }
+
     // XMLParser implementation
     XMLResult XMLParser::parse(const std::string& content) {
         XMLResult result;
+        if (options_.use_arena) {
+            if (!arena_blocks_) {
+                arena_blocks_ = std::make_shared<XMLResult::ArenaBlocks>();
+            }
+            result = XMLResult(arena_blocks_);
+        }
         size_t pos = 0;
         
-        try {
-            skip_whitespace(content, pos);
-            
-            // Skip XML declaration if present
-            if (pos < content.length() && content[pos] == '<' && pos + 1 < content.length() && content[pos + 1] == '?') {
-                skip_processing_instructions(content, pos);
-                skip_whitespace(content, pos);
-            }
-            
-            // Skip comments if present
-            while (pos < content.length() && content[pos] == '<' && pos + 3 < content.length() && 
-                   content.substr(pos, 4) == "<!--") {
-                skip_comments(content, pos);
-                skip_whitespace(content, pos);
-            }
-            
-            if (pos >= content.length()) {
-                throw std::runtime_error("No root element found");
-            }
-            
-            result.root = parse_node(content, pos, nullptr);
-            result.success = true;
-        } catch (const std::exception& e) {
-            result.success = false;
-            result.error_message = e.what();
+        // Per-document state lives in a fresh parser; this one only keeps arena blocks
+        XMLParser session(options_);
+        session.resource_ = result.root.get_allocator().resource();
+        if (options_.preserve_content) {
+            // One shared copy of the input backs all content nodes
+            session.source_ = make_shared_string(content, session.resource_);
+        }
+        ParseStatus status = session.parse_document(content, pos, result.root);
+        result.success = status.ok();
+        if (!result.success) {
+            result.error_location = ErrorLocation::from_offset(content, pos);
+            result.error_message = status.message + " at " + result.error_location.to_string();
         }
         
         return result;
@@ -191,46 +1054,333 @@ namespace parser {
         return parse(buffer.str());
     }
 
+    XMLResult XMLParser::parse_parallel(const std::string& content, size_t thread_count) {
+        if (thread_count == 0) {
+            thread_count = std::max<size_t>(1, std::thread::hardware_concurrency());
+        }
+        thread_count = std::min(thread_count, content.length() / kParallelMinChunk);
+        if (thread_count <= 1) {
+            return parse(content);
+        }
+        return XMLParser(options_).parse_split(content, thread_count, content.length() / thread_count + 1, nullptr);
+    }
+
+    XMLResult XMLParser::parse_records(const std::string& content, const RecordFunction& on_record, size_t thread_count) {
+        if (thread_count == 0) {
+            thread_count = std::max<size_t>(1, std::thread::hardware_concurrency());
+        }
+        thread_count = std::max<size_t>(1, std::min(thread_count, content.length() / kParallelMinChunk));
+        size_t chunk_size = std::min(content.length() / thread_count + 1, kRecordChunk);
+        return XMLParser(options_).parse_split(content, thread_count, chunk_size, &on_record);
+    }
+
     std::string XMLParser::to_string(const XMLResult& result, bool pretty_print) {
-        return node_to_string(result.root, 0, pretty_print);
+        std::string out;
+        XMLWriter writer;
+        writer.open_buffer(out);
+        writer.set_indent(pretty_print ? 2 : 0);
+        writer.write_node(result.root);
+        return out;
     }
 
     bool XMLParser::save_to_file(const XMLResult& result, const std::string& filename, bool pretty_print) {
-        std::ofstream file(filename);
-        if (!file.is_open()) {
+        XMLWriter writer;
+        if (!writer.open(filename)) {
             return false;
         }
-        
-        file << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>" << (pretty_print ? "\n" : "");
-        file << to_string(result, pretty_print);
-        return true;
+
+        writer.set_indent(pretty_print ? 2 : 0);
+        writer.declaration();
+        writer.write_node(result.root);
+        return writer.close();
     }
 
     // Private helper methods
-    XMLNode XMLParser::parse_node(const std::string& content, size_t& pos, XMLNode* parent) {
-        XMLNode node;
+    ParseStatus XMLParser::fail(const std::string& message) {
+        return ParseStatus{message};
+    }
+
+    ParseStatus XMLParser::parse_document(const std::string& content, size_t& pos, XMLNode& root) {
+        ParseStatus status = parse_prolog(content, pos);
+        if (status) {
+            status = parse_node(content, pos, root, nullptr);
+        }
+        if (status) {
+            status = parse_epilog(content, pos);
+        }
+        return status;
+    }
+
+    ParseStatus XMLParser::parse_prolog(const std::string& content, size_t& pos) {
+        const size_t max_document_size = options_.limits.max_document_size;
+        if (max_document_size != 0 && content.length() > max_document_size) {
+            pos = max_document_size;
+            return fail("Maximum document size exceeded");
+        }
+
+        bool doctype_seen = false;
+        while (true) {
+            skip_whitespace(content, pos);
+            if (content.compare(pos, 2, "<?") == 0) {
+                if (ParseStatus status = skip_processing_instructions(content, pos); !status) {
+                    return status;
+                }
+            } else if (content.compare(pos, 4, "<!--") == 0) {
+                if (ParseStatus status = skip_comments(content, pos); !status) {
+                    return status;
+                }
+            } else if (content.compare(pos, 9, "<!DOCTYPE") == 0) {
+                if (doctype_seen) {
+                    return fail("Multiple DOCTYPE declarations");
+                }
+                if (ParseStatus status = skip_doctype(content, pos); !status) {
+                    return status;
+                }
+                doctype_seen = true;
+            } else {
+                break;
+            }
+        }
+
+        if (pos >= content.length()) {
+            return fail("No root element found");
+        }
+        return {};
+    }
+
+    ParseStatus XMLParser::parse_epilog(const std::string& content, size_t& pos) {
+        while (true) {
+            skip_whitespace(content, pos);
+            if (pos >= content.length()) {
+                return {};
+            }
+            if (content.compare(pos, 2, "<?") == 0) {
+                if (ParseStatus status = skip_processing_instructions(content, pos); !status) {
+                    return status;
+                }
+            } else if (content.compare(pos, 4, "<!--") == 0) {
+                if (ParseStatus status = skip_comments(content, pos); !status) {
+                    return status;
+                }
+            } else {
+                return fail("Unexpected content after root element");
+            }
+        }
+    }
+
+    XMLResult XMLParser::parse_split(const std::string& content, size_t thread_count, size_t chunk_size, const RecordFunction* on_record) {
+        XMLResult result;
+        size_t pos = 0;
+
+        if (options_.preserve_content) {
+            source_ = make_shared_string(content, resource_);
+        }
+        const std::string& input = content;
+        XMLNode& root = result.root;
+
+        bool self_closing = false;
+        ParseStatus status = parse_prolog(input, pos);
+        if (status) {
+            status = parse_start_tag(input, pos, root, self_closing);
+        }
+        if (status && !self_closing) {
+            std::vector<size_t> splits;
+            if (find_split_points(input, pos, chunk_size, splits) && (on_record || splits.size() > 2)) {
+                status = parse_chunks(input, splits, thread_count, root, on_record, pos);
+            } else {
+                // Malformed or a single chunk: the sequential parser reports errors precisely
+                std::pmr::string text_content(root.get_allocator());
+                bool has_elements = false;
+                status = parse_content(input, pos, input.length(), root, text_content, has_elements);
+                if (status && !has_elements) {
+                    root.value = std::move(text_content);
+                }
+                if (status && on_record) {
+                    for (auto& child : root.children) {
+                        if (child.is_element()) {
+                            child.parent = nullptr;
+                            (*on_record)(child);
+                        }
+                    }
+                    root.children.clear();
+                }
+            }
+            if (status && pos >= input.length()) {
+                status = fail("Unexpected end of input");
+            }
+            if (status) {
+                status = parse_closing_tag(input, pos, root);
+            }
+        }
+        if (status) {
+            status = parse_epilog(input, pos);
+        }
+        if (status && options_.resolve_namespaces) {
+            namespaces_.pop();
+        }
+        source_.reset();
+
+        result.success = status.ok();
+        if (!result.success) {
+            result.error_location = ErrorLocation::from_offset(content, pos);
+            result.error_message = status.message + " at " + result.error_location.to_string();
+        }
+        return result;
+    }
+
+    ParseStatus XMLParser::parse_chunks(const std::string& content, const std::vector<size_t>& splits, size_t thread_count,
+                                        XMLNode& root, const RecordFunction* on_record, size_t& pos) {
+        struct Chunk {
+            XMLNode holder; // Receives the chunk's part of the root content
+            std::string error_message;
+            size_t error_pos = 0;
+            size_t element_count = 0;
+            bool failed = false;
+        };
+
+        auto work = [&](Chunk& chunk, size_t index) {
+            XMLParser worker(options_);
+            worker.source_ = source_;
+            if (options_.resolve_namespaces) {
+                // Declarations on the root are in scope for every record
+                XMLNode scope;
+                scope.name = root.name;
+                scope.attributes = root.attributes;
+                worker.resolve_namespaces(scope);
+            }
+
+            size_t chunk_pos = splits[index];
+            size_t chunk_end = splits[index + 1];
+            std::pmr::string text_content(chunk.holder.get_allocator());
+            bool has_elements = false;
+            ParseStatus status = worker.parse_content(content, chunk_pos, chunk_end, chunk.holder, text_content, has_elements);
+            if (status && chunk_pos != chunk_end) {
+                status = fail("Unexpected closing tag");
+            }
+            if (!status) {
+                chunk.failed = true;
+                chunk.error_message = std::move(status.message);
+                chunk.error_pos = chunk_pos;
+            }
+            chunk.element_count = worker.element_count_;
+        };
+
+        const size_t max_elements = options_.limits.max_elements;
+        size_t chunk_count = splits.size() - 1;
+        std::vector<Chunk> chunks;
+        std::vector<std::thread> workers;
+        for (size_t first = 0; first < chunk_count; first += thread_count) {
+            size_t round = std::min(thread_count, chunk_count - first);
+            chunks.clear();
+            chunks.resize(round);
+            workers.clear();
+            for (size_t i = 1; i < round; ++i) {
+                workers.emplace_back(work, std::ref(chunks[i]), first + i);
+            }
+            work(chunks[0], first);
+            for (auto& worker : workers) {
+                worker.join();
+            }
+
+            if (!on_record) {
+                size_t total = root.children.size();
+                for (const auto& chunk : chunks) {
+                    total += chunk.holder.children.size();
+                }
+                root.children.reserve(total);
+            }
+            // Hand over the records in document order, up to the first error
+            for (size_t i = 0; i < round; ++i) {
+                Chunk& chunk = chunks[i];
+                if (chunk.failed) {
+                    pos = chunk.error_pos;
+                    return fail(chunk.error_message);
+                }
+                // Each worker counted only its own chunk
+                element_count_ += chunk.element_count;
+                if (max_elements != 0 && element_count_ > max_elements) {
+                    pos = splits[first + i];
+                    return fail("Maximum element count exceeded");
+                }
+                for (auto& child : chunk.holder.children) {
+                    if (!on_record) {
+                        root.children.push_back(std::move(child));
+                        root.children.back().parent = &root;
+                    } else if (child.is_element()) {
+                        child.parent = nullptr;
+                        (*on_record)(child);
+                    }
+                }
+            }
+        }
+        pos = splits.back();
+        return {};
+    }
+
+    ParseStatus XMLParser::parse_node(const std::string& content, size_t& pos, XMLNode& node, XMLNode* parent) {
         node.parent = parent;
-        
+
+        bool self_closing = false;
+        if (ParseStatus status = parse_start_tag(content, pos, node, self_closing); !status) {
+            return status;
+        }
+        if (!self_closing) {
+            std::pmr::string text_content(node.get_allocator());
+            bool has_elements = false;
+            if (ParseStatus status = parse_content(content, pos, content.length(), node, text_content, has_elements); !status) {
+                return status;
+            }
+            if (pos >= content.length()) {
+                return fail("Unexpected end of input");
+            }
+            if (ParseStatus status = parse_closing_tag(content, pos, node); !status) {
+                return status;
+            }
+            // Assign value only if node has no child elements
+            if (!has_elements) {
+                node.value = std::move(text_content);
+            }
+        }
+        if (options_.resolve_namespaces) {
+            namespaces_.pop();
+        }
+        return {};
+    }
+
+    ParseStatus XMLParser::parse_start_tag(const std::string& content, size_t& pos, XMLNode& node, bool& self_closing) {
         skip_whitespace(content, pos);
         
         if (pos >= content.length() || content[pos] != '<') {
-            throw std::runtime_error("Expected '<' at start of element");
+            return fail("Expected '<' at start of element");
         }
         
+        const size_t tag_start = pos;
         pos++; // Skip '<'
         
         if (pos >= content.length()) {
-            throw std::runtime_error("Unexpected end of input");
+            return fail("Unexpected end of input");
         }
         
         // Check for closing tag
         if (content[pos] == '/') {
-            throw std::runtime_error("Unexpected closing tag");
+            return fail("Unexpected closing tag");
+        }
+
+        const size_t max_elements = options_.limits.max_elements;
+        if (max_elements != 0 && ++element_count_ > max_elements) {
+            pos--; // Report the error at the '<'
+            return fail("Maximum element count exceeded");
         }
         
         // Parse element name and attributes
-        if (!parse_element_tag(content, pos, node)) {
-            throw std::runtime_error("Failed to parse element tag");
+        if (ParseStatus status = parse_element_tag(content, pos, node); !status) {
+            return status;
+        }
+        if (options_.resolve_namespaces) {
+            if (ParseStatus status = resolve_namespaces(node); !status) {
+                pos = tag_start; // Report the error at the '<', as XMLReader does
+                return status;
+            }
         }
         
         skip_whitespace(content, pos);
@@ -240,326 +1390,341 @@ namespace parser {
             pos++; // Skip '/'
             skip_whitespace(content, pos);
             if (pos >= content.length() || content[pos] != '>') {
-                throw std::runtime_error("Expected '>' after '/' in self-closing tag");
+                return fail("Expected '>' after '/' in self-closing tag");
             }
             pos++; // Skip '>'
-            return node;
+            self_closing = true;
+            return {};
         }
         
         if (pos >= content.length() || content[pos] != '>') {
-            throw std::runtime_error("Expected '>' after element tag");
+            return fail("Expected '>' after element tag");
         }
         
         pos++; // Skip '>'
-        
-        // Parse content and child elements
-        std::string text_content = parse_text_content(content, pos);
-        
-        // Parse child elements
-        while (pos < content.length()) {
-            skip_whitespace(content, pos);
-            if (pos >= content.length()) {
-                throw std::runtime_error("Unexpected end of input");
-            }
-            if (content[pos] == '<') {
-                pos++; // Skip '<'
-                if (pos >= content.length()) {
-                    throw std::runtime_error("Unexpected end of input");
-                }
-                if (content[pos] == '/') {
-                    // Closing tag
-                    pos++; // Skip '/'
-                    skip_whitespace(content, pos);
-                    // Find closing tag name
-                    size_t tag_end = content.find('>', pos);
-                    if (tag_end == std::string::npos) {
-                        throw std::runtime_error("Unterminated closing tag");
-                    }
-                    std::string closing_name = trim(content.substr(pos, tag_end - pos));
-                    if (closing_name != node.name) {
-                        throw std::runtime_error("Mismatched closing tag: expected '" + node.name + "', got '" + closing_name + "'");
-                    }
-                    pos = tag_end + 1; // Skip '>'
-                    break;
-                } else {
-                    // Child element
-                    pos--; // Go back to '<'
-                    XMLNode child = parse_node(content, pos, &node);
-                    node.add_child(child);
+        self_closing = false;
+        return {};
+    }
+
+    ParseStatus XMLParser::parse_content(const std::string& content, size_t& pos, size_t end, XMLNode& node,
+                                         std::pmr::string& text_content, bool& has_elements) {
+        // text_content shares the node's allocator, so it moves into the value without a copy
+        struct Frame {
+            XMLNode* node;
+            std::pmr::string text_content;
+            bool has_elements;
+        };
+
+        const bool preserve = options_.preserve_content;
+        const size_t max_depth = options_.limits.max_depth;
+        const size_t max_text_size = options_.limits.max_text_size;
+
+        // Open elements; the first is node, whose closing tag the caller parses
+        std::vector<Frame> open;
+        open.push_back(Frame{&node, std::move(text_content), has_elements});
+        bool leading = true;
+        while (true) {
+            Frame& frame = open.back();
+
+            // Only text before the first child keeps its leading whitespace
+            if (!preserve && !leading) {
+                skip_whitespace(content, pos);
+            }
+            leading = false;
+            size_t text_end = detail::scan_text(content, pos, frame.text_content);
+            if (preserve && text_end > pos) {
+                add_content(*frame.node, XMLNode::Type::Text, pos, text_end);
+            }
+            pos = text_end;
+            if (max_text_size != 0 && frame.text_content.size() > max_text_size) {
+                return fail("Maximum text size exceeded");
+            }
+
+            if (open.size() == 1) {
+                if (pos >= end || content.compare(pos, 2, "</") == 0) {
+                    text_content = std::move(frame.text_content);
+                    has_elements = frame.has_elements;
+                    return {};
                 }
-            } else {
-                // More text content
-                std::string more_text = parse_text_content(content, pos);
-                if (!more_text.empty()) {
-                    text_content += more_text;
+            } else if (pos >= content.length()) {
+                return fail("Unexpected end of input");
+            } else if (content.compare(pos, 2, "</") == 0) {
+                if (ParseStatus status = parse_closing_tag(content, pos, *frame.node); !status) {
+                    return status;
+                }
+                // Assign value only if node has no child elements
+                if (!frame.has_elements) {
+                    frame.node->value = std::move(frame.text_content);
+                }
+                if (options_.resolve_namespaces) {
+                    namespaces_.pop();
+                }
+                open.pop_back();
+                continue;
+            }
+
+            if (content.compare(pos, 2, "<!") == 0 || content.compare(pos, 2, "<?") == 0) {
+                if (ParseStatus status = parse_markup(content, pos, *frame.node, frame.text_content); !status) {
+                    return status;
+                }
+                continue;
+            }
+
+            // Child element, parsed in place
+            if (max_depth != 0 && open.size() >= max_depth) {
+                return fail("Maximum depth exceeded");
+            }
+            frame.has_elements = true;
+            XMLNode& child = frame.node->children.emplace_back();
+            child.parent = frame.node;
+            bool self_closing = false;
+            if (ParseStatus status = parse_start_tag(content, pos, child, self_closing); !status) {
+                return status;
+            }
+            if (self_closing) {
+                if (options_.resolve_namespaces) {
+                    namespaces_.pop();
                 }
+                continue;
             }
+            open.push_back(Frame{&child, std::pmr::string(child.get_allocator()), false});
+            leading = true;
         }
-        // Assign value only if node has no children
-        if (node.children.empty()) {
-            node.value = text_content;
+    }
+
+    ParseStatus XMLParser::parse_closing_tag(const std::string& content, size_t& pos, const XMLNode& node) {
+        pos += 2; // Skip "</"
+        skip_whitespace(content, pos);
+        // Find closing tag name
+        size_t tag_end = content.find('>', pos);
+        if (tag_end == std::string::npos) {
+            return fail("Unterminated closing tag");
         }
-        return node;
+        // Compare against the span in the input, without copying it
+        std::string_view closing_name = detail::trim(std::string_view(content).substr(pos, tag_end - pos));
+        if (closing_name != node.name) {
+            return fail("Mismatched closing tag: expected '" + std::string(node.name) + "', got '" + std::string(closing_name) + "'");
+        }
+        pos = tag_end + 1; // Skip '>'
+        return {};
     }
 
-    bool XMLParser::parse_element_tag(const std::string& content, size_t& pos, XMLNode& node) {
+    ParseStatus XMLParser::parse_element_tag(const std::string& content, size_t& pos, XMLNode& node) {
         // Parse element name
-        size_t name_start = pos;
-        while (pos < content.length() && !std::isspace(content[pos]) && content[pos] != '>' && content[pos] != '/') {
-            pos++;
+        std::string_view name = detail::scan_element_name(content, pos);
+        if (name.empty()) {
+            return fail("Failed to parse element tag");
         }
-        
-        if (pos == name_start) {
-            return false;
+        const size_t max_name_length = options_.limits.max_name_length;
+        if (max_name_length != 0 && name.size() > max_name_length) {
+            pos -= name.size();
+            return fail("Maximum name length exceeded");
         }
         
-        node.name = content.substr(name_start, pos - name_start);
+        node.name.assign(name.data(), name.size());
         
         skip_whitespace(content, pos);
         
         // Parse attributes
-        parse_attributes(content, pos, node);
-        
-        return true;
+        return parse_attributes(content, pos, node);
     }
 
-    void XMLParser::parse_attributes(const std::string& content, size_t& pos, XMLNode& node) {
-        while (pos < content.length() && content[pos] != '>' && content[pos] != '/') {
+    ParseStatus XMLParser::parse_attributes(const std::string& content, size_t& pos, XMLNode& node) {
+        const XMLLimits& limits = options_.limits;
+        size_t count = 0;
+        while (true) {
             skip_whitespace(content, pos);
             
             if (pos >= content.length() || content[pos] == '>' || content[pos] == '/') {
                 break;
             }
             
-            // Parse attribute name
-            size_t name_start = pos;
-            while (pos < content.length() && !std::isspace(content[pos]) && content[pos] != '=' && content[pos] != '>' && content[pos] != '/') {
-                pos++;
+            if (limits.max_attributes != 0 && ++count > limits.max_attributes) {
+                return fail("Maximum attribute count exceeded");
             }
-            
-            if (pos == name_start) {
-                throw std::runtime_error("Invalid attribute name");
+            size_t attr_pos = pos;
+            std::string_view attr_name;
+            std::string_view raw_value;
+            if (const char* error = detail::scan_attribute(content, pos, attr_name, raw_value)) {
+                return fail(error);
             }
-            
-            std::string attr_name = content.substr(name_start, pos - name_start);
-            
-            skip_whitespace(content, pos);
-            
-            if (pos >= content.length() || content[pos] != '=') {
-                throw std::runtime_error("Expected '=' after attribute name");
+            if (limits.max_name_length != 0 && attr_name.size() > limits.max_name_length) {
+                pos = attr_pos;
+                return fail("Maximum name length exceeded");
             }
-            
-            pos++; // Skip '='
-            skip_whitespace(content, pos);
-            
-            if (pos >= content.length()) {
-                throw std::runtime_error("Unexpected end of input in attribute");
+            if (limits.max_text_size != 0 && raw_value.size() > limits.max_text_size) {
+                pos = attr_pos;
+                return fail("Maximum text size exceeded");
             }
             
-            std::string attr_value = parse_attribute_value(content, pos);
-            node.set_attribute(attr_name, attr_value);
+            std::pmr::string& attr_value = node.attributes[attr_name];
+            attr_value.clear();
+            detail::decode_entities(raw_value, attr_value);
         }
+        return {};
     }
 
-    std::string XMLParser::parse_attribute_value(const std::string& content, size_t& pos) {
-        if (pos >= content.length()) {
-            throw std::runtime_error("Unexpected end of input in attribute value");
-        }
-        
-        char quote = content[pos];
-        if (quote != '"' && quote != '\'') {
-            throw std::runtime_error("Expected quote in attribute value");
+    ParseStatus XMLParser::parse_markup(const std::string& content, size_t& pos, XMLNode& node, std::pmr::string& text_content) {
+        const bool preserve = options_.preserve_content;
+        if (content.compare(pos, 4, "<!--") == 0) {
+            size_t end_pos = content.find("-->", pos + 4);
+            if (end_pos == std::string::npos) {
+                return fail("Unterminated comment");
+            }
+            if (preserve) {
+                add_content(node, XMLNode::Type::Comment, pos + 4, end_pos);
+            }
+            pos = end_pos + 3; // Skip "-->"
+            return {};
         }
-        
-        pos++; // Skip opening quote
-        size_t value_start = pos;
-        
-        while (pos < content.length() && content[pos] != quote) {
-            pos++;
+        if (content.compare(pos, 9, "<![CDATA[") == 0) {
+            size_t end_pos = content.find("]]>", pos + 9);
+            if (end_pos == std::string::npos) {
+                return fail("Unterminated CDATA section");
+            }
+            text_content.append(content, pos + 9, end_pos - pos - 9);
+            if (preserve) {
+                add_content(node, XMLNode::Type::CData, pos + 9, end_pos);
+            }
+            pos = end_pos + 3; // Skip "]]>"
+            return {};
         }
-        
-        if (pos >= content.length()) {
-            throw std::runtime_error("Unterminated attribute value");
+        if (content.compare(pos, 2, "<?") == 0) {
+            size_t end_pos = content.find("?>", pos + 2);
+            if (end_pos == std::string::npos) {
+                return fail("Unterminated processing instruction");
+            }
+            if (preserve) {
+                add_content(node, XMLNode::Type::ProcessingInstruction, pos + 2, end_pos);
+            }
+            pos = end_pos + 2; // Skip "?>"
+            return {};
         }
-        
-        std::string value = content.substr(value_start, pos - value_start);
-        pos++; // Skip closing quote
-        
-        return value;
+        return fail("Unsupported markup declaration");
     }
 
-    std::string XMLParser::parse_text_content(const std::string& content, size_t& pos) {
-        size_t start = pos;
-        
-        while (pos < content.length() && content[pos] != '<') {
-            pos++;
+    ParseStatus XMLParser::resolve_namespaces(XMLNode& node) {
+        namespaces_.push();
+        for (const auto& attr : node.attributes) {
+            std::string_view prefix;
+            if (XMLNamespaceScope::is_declaration(attr.name, prefix)) {
+                if (const char* error = namespaces_.bind(prefix, attr.value)) {
+                    return fail(error);
+                }
+            }
         }
-        
-        std::string text = content.substr(start, pos - start);
-        
-        // Decode XML entities
-        // This is a simple implementation - in a real parser you'd want more comprehensive entity handling
-        size_t amp_pos = text.find("&amp;");
-        while (amp_pos != std::string::npos) {
-            text.replace(amp_pos, 5, "&");
-            amp_pos = text.find("&amp;", amp_pos + 1);
+
+        uint32_t id;
+        if (!namespaces_.resolve(XMLNamespaceScope::prefix(node.name), id)) {
+            return fail("Unbound namespace prefix '" + std::string(XMLNamespaceScope::prefix(node.name)) + "'");
         }
-        
-        size_t lt_pos = text.find("&lt;");
-        while (lt_pos != std::string::npos) {
-            text.replace(lt_pos, 4, "<");
-            lt_pos = text.find("&lt;", lt_pos + 1);
+        node.namespace_ = namespace_string(id);
+
+        for (auto& attr : node.attributes.items_) {
+            std::string_view prefix = XMLNamespaceScope::prefix(attr.name);
+            if (prefix.empty()) {
+                // Unprefixed attributes have no namespace, except xmlns itself
+                id = XMLNamespaceScope::npos;
+                if (attr.name == "xmlns") {
+                    namespaces_.resolve("xmlns", id);
+                }
+            } else if (!namespaces_.resolve(prefix, id)) {
+                return fail("Unbound namespace prefix '" + std::string(prefix) + "'");
+            }
+            attr.namespace_ = namespace_string(id);
         }
-        
-        size_t gt_pos = text.find("&gt;");
-        while (gt_pos != std::string::npos) {
-            text.replace(gt_pos, 4, ">");
-            gt_pos = text.find("&gt;", gt_pos + 1);
+
+        // Different prefixes can name the same attribute once resolved;
+        // namespace strings are interned, so equal URIs share a pointer
+        const auto& items = node.attributes.items_;
+        for (size_t i = 0; i < items.size(); ++i) {
+            if (!items[i].namespace_) {
+                continue;
+            }
+            for (size_t j = 0; j < i; ++j) {
+                if (items[j].namespace_ == items[i].namespace_ && items[j].local_name() == items[i].local_name()) {
+                    return fail("Duplicate attribute '" + std::string(items[i].local_name()) + "' in namespace '" +
+                                std::string(*items[i].namespace_) + "'");
+                }
+            }
         }
-        
-        size_t quot_pos = text.find("&quot;");
-        while (quot_pos != std::string::npos) {
-            text.replace(quot_pos, 6, "\"");
-            quot_pos = text.find("&quot;", quot_pos + 1);
+        return {};
+    }
+
+    const std::shared_ptr<const std::pmr::string>& XMLParser::namespace_string(uint32_t id) {
+        static const std::shared_ptr<const std::pmr::string> none;
+        if (id == XMLNamespaceScope::npos) {
+            return none;
         }
-        
-        size_t apos_pos = text.find("&apos;");
-        while (apos_pos != std::string::npos) {
-            text.replace(apos_pos, 6, "'");
-            apos_pos = text.find("&apos;", apos_pos + 1);
+        if (id >= namespace_strings_.size()) {
+            namespace_strings_.resize(namespaces_.uri_count());
         }
-        
-        return text;
+        if (!namespace_strings_[id]) {
+            namespace_strings_[id] = make_shared_string(namespaces_.uri(id), resource_);
+        }
+        return namespace_strings_[id];
+    }
+
+    void XMLParser::add_content(XMLNode& node, XMLNode::Type type, size_t start, size_t end) {
+        node.children.emplace_back();
+        XMLNode& content_node = node.children.back();
+        content_node.type = type;
+        content_node.parent = &node;
+        content_node.source_ = source_;
+        content_node.raw_offset_ = start;
+        content_node.raw_length_ = end - start;
     }
 
     void XMLParser::skip_whitespace(const std::string& content, size_t& pos) {
-        while (pos < content.length() && std::isspace(content[pos])) {
-            pos++;
-        }
+        detail::skip_whitespace(content, pos);
     }
 
-    void XMLParser::skip_comments(const std::string& content, size_t& pos) {
-        if (content.substr(pos, 4) != "<!--") {
-            return;
+    ParseStatus XMLParser::skip_comments(const std::string& content, size_t& pos) {
+        if (content.compare(pos, 4, "<!--") != 0) {
+            return {};
         }
         
         pos += 4; // Skip "<!--"
         
         size_t end_pos = content.find("-->", pos);
         if (end_pos == std::string::npos) {
-            throw std::runtime_error("Unterminated comment");
+            return fail("Unterminated comment");
         }
         
         pos = end_pos + 3; // Skip "-->"
+        return {};
     }
 
-    void XMLParser::skip_processing_instructions(const std::string& content, size_t& pos) {
+    ParseStatus XMLParser::skip_processing_instructions(const std::string& content, size_t& pos) {
         if (content[pos] != '<' || pos + 1 >= content.length() || content[pos + 1] != '?') {
-            return;
+            return {};
         }
         
         pos += 2; // Skip "<?"
         
         size_t end_pos = content.find("?>", pos);
         if (end_pos == std::string::npos) {
-            throw std::runtime_error("Unterminated processing instruction");
+            return fail("Unterminated processing instruction");
         }
         
         pos = end_pos + 2; // Skip "?>"
+        return {};
     }
 
-    std::string XMLParser::node_to_string(const XMLNode& node, int indent, bool pretty_print) {
-        std::string indent_str = pretty_print ? std::string(indent * 2, ' ') : "";
-        std::string newline = pretty_print ? "\n" : "";
-        
-        std::string result = indent_str + "<" + node.name;
-        
-        // Add attributes
-        for (const auto& attr : node.attributes) {
-            result += " " + attr.first + "=\"" + attr.second + "\"";
-        }
-        
-        if (node.children.empty() && node.value.empty()) {
-            result += " />";
-            return result;
-        }
-        
-        result += ">";
-        
-        if (!node.value.empty()) {
-            // Encode XML entities in text content
-            std::string encoded_value = node.value;
-            size_t amp_pos = encoded_value.find("&");
-            while (amp_pos != std::string::npos) {
-                encoded_value.replace(amp_pos, 1, "&amp;");
-                amp_pos = encoded_value.find("&", amp_pos + 5);
-            }
-            
-            size_t lt_pos = encoded_value.find("<");
-            while (lt_pos != std::string::npos) {
-                encoded_value.replace(lt_pos, 1, "&lt;");
-                lt_pos = encoded_value.find("<", lt_pos + 4);
-            }
-            
-            size_t gt_pos = encoded_value.find(">");
-            while (gt_pos != std::string::npos) {
-                encoded_value.replace(gt_pos, 1, "&gt;");
-                gt_pos = encoded_value.find(">", gt_pos + 4);
-            }
-            
-            result += encoded_value;
-        }
-        
-        // Add child elements
-        for (const auto& child : node.children) {
-            result += newline + node_to_string(child, indent + 1, pretty_print);
-        }
-        
-        result += "</" + node.name + ">";
-        
-        return result;
-    }
-
-    const XMLNode* XMLParser::get_node_by_path(const XMLNode& root, const std::string& path) const {
-        if (path.empty()) {
-            return &root;
-        }
-        
-        std::vector<std::string> components = split_path(path);
-        const XMLNode* current = &root;
-        
-        for (const auto& component : components) {
-            current = current->get_child(component);
-            if (!current) {
-                return nullptr;
-            }
+    ParseStatus XMLParser::skip_doctype(const std::string& content, size_t& pos) {
+        size_t scan = pos + 9; // Skip "<!DOCTYPE"
+        bool in_subset = false;
+        size_t end_pos = detail::find_doctype_end(content, scan, in_subset);
+        if (end_pos == std::string::npos) {
+            return fail("Unterminated DOCTYPE declaration");
         }
-        
-        return current;
-    }
 
-    std::vector<std::string> XMLParser::split_path(const std::string& path) const {
-        std::vector<std::string> components;
-        std::istringstream path_stream(path);
-        std::string component;
-        
-        while (std::getline(path_stream, component, '.')) {
-            if (!component.empty()) {
-                components.push_back(component);
-            }
-        }
-        
-        return components;
+        pos = end_pos + 1; // Skip '>'
+        return {};
     }
 
-    std::string XMLParser::trim(const std::string& str) {
-        size_t start = str.find_first_not_of(" \t\r\n");
-        if (start == std::string::npos) {
-            return "";
-        }
-        
-        size_t end = str.find_last_not_of(" \t\r\n");
-        return str.substr(start, end - start + 1);
+    const XMLNode* XMLParser::get_node_by_path(const XMLNode& root, const std::string& path) const {
+        return XMLPath::resolve(root, path);
     }
 
 } // namespace parser 
\ No newline at end of file
@@ -0,0 +1,445 @@
+#include "parsers/xml_query.h"
+#include <algorithm>
+#include <cctype>
+
+namespace parser {
+
+    namespace {
+
+        bool is_name_char(char c) {
+            switch (c) {
+                case '/': case '[': case ']': case '@': case '=':
+                case '(': case ')': case '\'': case '"': case '*':
+                    return false;
+                default:
+                    return !std::isspace(static_cast<unsigned char>(c));
+            }
+        }
+
+        std::string scan_name(const std::string& expression, size_t& pos) {
+            size_t start = pos;
+            while (pos < expression.length() && is_name_char(expression[pos])) {
+                pos++;
+            }
+            return expression.substr(start, pos - start);
+        }
+
+        void skip_spaces(const std::string& expression, size_t& pos) {
+            while (pos < expression.length() && std::isspace(static_cast<unsigned char>(expression[pos]))) {
+                pos++;
+            }
+        }
+
+    } // namespace
+
+    // XMLQuery implementation
+    XMLQuery XMLQuery::compile(const std::string& expression) {
+        XMLQuery query;
+        query.success = query.parse(expression);
+        if (!query.success) {
+            query.steps_.clear();
+            query.predicates_.clear();
+        }
+        return query;
+    }
+
+    XMLQuery::Range XMLQuery::select(const XMLNode& context) const {
+        if (!success) {
+            return Range(nullptr, nullptr, nullptr);
+        }
+        return Range(this, &context, absolute_ ? nullptr : &context);
+    }
+
+    XMLQuery::Range XMLQuery::select(const XMLResult& result) const {
+        return select(result.root);
+    }
+
+    const XMLNode* XMLQuery::first(const XMLNode& context) const {
+        Iterator it = select(context).begin();
+        return it == Iterator() ? nullptr : &*it;
+    }
+
+    std::string XMLQuery::first_value(const XMLNode& context, const std::string& default_value) const {
+        Iterator it = select(context).begin();
+        return it == Iterator() ? default_value : std::string(it.value());
+    }
+
+    bool XMLQuery::parse(const std::string& expression) {
+        size_t pos = 0;
+        bool descendant = false;
+        if (expression.compare(0, 2, "//") == 0) {
+            absolute_ = true;
+            descendant = true;
+            pos = 2;
+        } else if (expression.compare(0, 1, "/") == 0) {
+            absolute_ = true;
+            pos = 1;
+        }
+
+        // A // step is fused with the element step after it into one
+        // descendant step, which tests each node as its walk reaches it
+        auto descendant_step = [this]() {
+            Step step;
+            step.axis = Axis::Descendant;
+            step.nested = std::any_of(steps_.begin(), steps_.end(), [](const Step& previous) {
+                return previous.axis == Axis::Descendant || previous.axis == Axis::DescendantOrSelf;
+            });
+            return step;
+        };
+
+        while (true) {
+            if (pos >= expression.length()) {
+                return fail(expression, pos, "Expected a step");
+            }
+
+            // text() and @attr select from the nodes of the step before them
+            bool is_text = expression.compare(pos, 6, "text()") == 0;
+            if (is_text || expression[pos] == '@') {
+                if (is_text) {
+                    pos += 6;
+                    output_ = Output::Text;
+                } else {
+                    pos++; // Skip '@'
+                    output_attribute_ = scan_name(expression, pos);
+                    if (output_attribute_.empty()) {
+                        return fail(expression, pos, "Expected an attribute name");
+                    }
+                    output_ = Output::Attribute;
+                }
+                if (pos != expression.length()) {
+                    return fail(expression, pos, "text() and @attribute must be the last step");
+                }
+                if (descendant) {
+                    steps_.push_back(descendant_step());
+                } else if (steps_.empty()) {
+                    if (absolute_) {
+                        return fail(expression, pos, "Expected an element step");
+                    }
+                    Step step;
+                    step.axis = Axis::Self;
+                    steps_.push_back(step);
+                }
+                return true;
+            }
+
+            Step step = descendant ? descendant_step() : Step();
+            if (expression[pos] == '.') {
+                if (descendant) {
+                    // //. selects the walked nodes themselves, so it keeps its own step
+                    step.axis = Axis::DescendantOrSelf;
+                    steps_.push_back(step);
+                    step = Step();
+                }
+                step.axis = Axis::Self;
+                pos++;
+            } else if (expression[pos] == '*') {
+                pos++;
+            } else {
+                step.name = scan_name(expression, pos);
+                if (step.name.empty()) {
+                    return fail(expression, pos, "Expected an element name");
+                }
+            }
+
+            step.first_predicate = predicates_.size();
+            while (pos < expression.length() && expression[pos] == '[') {
+                if (!parse_predicate(expression, pos)) {
+                    return false;
+                }
+            }
+            step.predicate_count = predicates_.size() - step.first_predicate;
+            steps_.push_back(step);
+            descendant = false;
+
+            if (pos >= expression.length()) {
+                return true;
+            }
+            if (expression.compare(pos, 2, "//") == 0) {
+                descendant = true;
+                pos += 2;
+            } else if (expression[pos] == '/') {
+                pos++;
+            } else {
+                return fail(expression, pos, "Unexpected character");
+            }
+        }
+    }
+
+    bool XMLQuery::parse_predicate(const std::string& expression, size_t& pos) {
+        pos++; // Skip '['
+        skip_spaces(expression, pos);
+
+        Predicate predicate;
+        bool needs_value = false;
+        if (pos < expression.length() && std::isdigit(static_cast<unsigned char>(expression[pos]))) {
+            predicate.kind = Predicate::Kind::Position;
+            while (pos < expression.length() && std::isdigit(static_cast<unsigned char>(expression[pos]))) {
+                predicate.position = predicate.position * 10 + static_cast<size_t>(expression[pos] - '0');
+                pos++;
+            }
+            if (predicate.position == 0) {
+                return fail(expression, pos, "Positions start at 1");
+            }
+        } else if (pos < expression.length() && expression[pos] == '@') {
+            pos++; // Skip '@'
+            predicate.name = scan_name(expression, pos);
+            if (predicate.name.empty()) {
+                return fail(expression, pos, "Expected an attribute name");
+            }
+            skip_spaces(expression, pos);
+            predicate.kind = Predicate::Kind::HasAttribute;
+            if (pos < expression.length() && expression[pos] == '=') {
+                predicate.kind = Predicate::Kind::AttributeEquals;
+                needs_value = true;
+            }
+        } else if (expression.compare(pos, 6, "text()") == 0) {
+            pos += 6;
+            skip_spaces(expression, pos);
+            if (pos >= expression.length() || expression[pos] != '=') {
+                return fail(expression, pos, "Expected '=' after text()");
+            }
+            predicate.kind = Predicate::Kind::TextEquals;
+            needs_value = true;
+        } else {
+            return fail(expression, pos, "Unsupported predicate");
+        }
+
+        if (needs_value) {
+            pos++; // Skip '='
+            skip_spaces(expression, pos);
+            if (pos >= expression.length() || (expression[pos] != '\'' && expression[pos] != '"')) {
+                return fail(expression, pos, "Expected a quoted value");
+            }
+            size_t end = expression.find(expression[pos], pos + 1);
+            if (end == std::string::npos) {
+                return fail(expression, pos, "Unterminated value");
+            }
+            predicate.value = expression.substr(pos + 1, end - pos - 1);
+            pos = end + 1;
+            skip_spaces(expression, pos);
+        }
+
+        if (pos >= expression.length() || expression[pos] != ']') {
+            return fail(expression, pos, "Expected ']'");
+        }
+        pos++; // Skip ']'
+        predicates_.push_back(predicate);
+        return true;
+    }
+
+    bool XMLQuery::fail(const std::string& expression, size_t pos, const std::string& message) {
+        error_message = "Invalid query: " + message + " at " + ErrorLocation::from_offset(expression, pos).to_string();
+        return false;
+    }
+
+    bool XMLQuery::matches(const Step& step, const XMLNode& node, size_t* counters) const {
+        if (!node.is_element() || (!step.name.empty() && node.name != std::string_view(step.name))) {
+            return false;
+        }
+        for (size_t i = step.first_predicate; i < step.first_predicate + step.predicate_count; ++i) {
+            const Predicate& predicate = predicates_[i];
+            switch (predicate.kind) {
+                case Predicate::Kind::Position:
+                    // Counts the siblings that passed the predicates before this one
+                    if (++counters[i - step.first_predicate] != predicate.position) {
+                        return false;
+                    }
+                    break;
+                case Predicate::Kind::HasAttribute:
+                    if (!node.has_attribute(predicate.name)) {
+                        return false;
+                    }
+                    break;
+                case Predicate::Kind::AttributeEquals: {
+                    auto it = node.attributes.find(predicate.name);
+                    if (it == node.attributes.end() || it->value != std::string_view(predicate.value)) {
+                        return false;
+                    }
+                    break;
+                }
+                case Predicate::Kind::TextEquals:
+                    if (node.value != std::string_view(predicate.value)) {
+                        return false;
+                    }
+                    break;
+            }
+        }
+        return true;
+    }
+
+    // XMLQuery::Iterator implementation
+    XMLQuery::Iterator::Iterator(const XMLQuery* query, const XMLNode* root, const XMLNode* context)
+        : query_(query), root_(root) {
+        if (!query_) {
+            return;
+        }
+        frames_.resize(query_->steps_.size());
+        counters_.resize(query_->predicates_.size());
+        enter(0, context);
+        advance();
+    }
+
+    XMLQuery::Iterator& XMLQuery::Iterator::operator++() {
+        advance();
+        return *this;
+    }
+
+    XMLQuery::Iterator XMLQuery::Iterator::operator++(int) {
+        Iterator previous = *this;
+        advance();
+        return previous;
+    }
+
+    const std::pmr::string& XMLQuery::Iterator::value() const {
+        if (query_->output_ == Output::Attribute) {
+            return current_->attributes.find(query_->output_attribute_)->value;
+        }
+        return current_->value;
+    }
+
+    void XMLQuery::Iterator::enter(size_t level, const XMLNode* context) {
+        Frame& frame = frames_[level];
+        const Step& step = query_->steps_[level];
+        frame.context = context;
+        frame.started = false;
+
+        if (step.axis == Axis::Child) {
+            if (context) {
+                frame.next = context->children.data();
+                frame.end = frame.next + context->children.size();
+            } else {
+                frame.next = root_;
+                frame.end = root_ + 1;
+            }
+            for (size_t i = step.first_predicate; i < step.first_predicate + step.predicate_count; ++i) {
+                counters_[i] = 0;
+            }
+        }
+    }
+
+    bool XMLQuery::Iterator::produce(size_t level, const XMLNode*& node) {
+        Frame& frame = frames_[level];
+        const Step& step = query_->steps_[level];
+
+        switch (step.axis) {
+            case Axis::Child:
+                while (frame.next != frame.end) {
+                    const XMLNode* candidate = frame.next++;
+                    if (query_->matches(step, *candidate, counters_.data() + step.first_predicate)) {
+                        node = candidate;
+                        return true;
+                    }
+                }
+                return false;
+
+            case Axis::Self:
+                if (frame.started || !frame.context) {
+                    return false;
+                }
+                frame.started = true;
+                for (size_t i = step.first_predicate; i < step.first_predicate + step.predicate_count; ++i) {
+                    counters_[i] = 0;
+                }
+                if (!query_->matches(step, *frame.context, counters_.data() + step.first_predicate)) {
+                    return false;
+                }
+                node = frame.context;
+                return true;
+
+            case Axis::Descendant:
+            case Axis::DescendantOrSelf: {
+                const size_t counters = step.axis == Axis::Descendant ? step.predicate_count : 0;
+                if (!frame.started) {
+                    frame.started = true;
+                    if (step.nested && frame.context) {
+                        // A context inside one walked before has had its whole subtree reported
+                        for (const XMLNode* ancestor = frame.context; ancestor; ancestor = ancestor->parent) {
+                            if (frame.walked.count(ancestor)) {
+                                return false;
+                            }
+                        }
+                        frame.walked.insert(frame.context);
+                    }
+                    frame.stack_base = stack_.size();
+                    if (frame.context) {
+                        const auto& children = frame.context->children;
+                        push_siblings(children.data(), children.data() + children.size(), counters);
+                    } else {
+                        push_siblings(root_, root_ + 1, counters);
+                    }
+                    if (step.axis == Axis::DescendantOrSelf) {
+                        node = frame.context;
+                        return true;
+                    }
+                }
+                // Pre-order walk; the stack holds the unvisited siblings per level
+                while (stack_.size() > frame.stack_base) {
+                    Siblings& top = stack_.back();
+                    if (top.next == top.end) {
+                        pop_siblings();
+                        continue;
+                    }
+                    const XMLNode* candidate = top.next++;
+                    // Test before descending, while top's counters are the candidate's siblings'
+                    const bool matched = step.axis == Axis::DescendantOrSelf ||
+                                         query_->matches(step, *candidate, walk_counters_.data() + top.counters);
+                    if (!candidate->children.empty()) {
+                        const auto& children = candidate->children;
+                        push_siblings(children.data(), children.data() + children.size(), counters);
+                    }
+                    if (matched) {
+                        node = candidate;
+                        return true;
+                    }
+                }
+                return false;
+            }
+        }
+        return false;
+    }
+
+    void XMLQuery::Iterator::push_siblings(const XMLNode* first, const XMLNode* last, size_t counters) {
+        stack_.push_back(Siblings{first, last, walk_counters_.size()});
+        walk_counters_.resize(walk_counters_.size() + counters, 0);
+    }
+
+    void XMLQuery::Iterator::pop_siblings() {
+        walk_counters_.resize(stack_.back().counters);
+        stack_.pop_back();
+    }
+
+    void XMLQuery::Iterator::advance() {
+        const size_t last = frames_.size() - 1;
+        while (true) {
+            const XMLNode* node = nullptr;
+            if (!produce(level_, node)) {
+                if (level_ == 0) {
+                    current_ = nullptr;
+                    return;
+                }
+                level_--;
+                continue;
+            }
+
+            if (level_ < last) {
+                enter(level_ + 1, node);
+                level_++;
+                continue;
+            }
+
+            // The document itself is never a result
+            if (!node) {
+                continue;
+            }
+            if (query_->output_ == Output::Attribute && !node->has_attribute(query_->output_attribute_)) {
+                continue;
+            }
+            if (query_->output_ == Output::Text && node->value.empty()) {
+                continue;
+            }
+            current_ = node;
+            return;
+        }
+    }
+
+} // namespace parser
@@ -0,0 +1,550 @@
+#include "parsers/xml_reader.h"
+#include "parsers/xml_scanner.h"
+#include <algorithm>
+#include <cstring>
+
+namespace parser {
+
+    bool XMLReader::open(const std::string& filename) {
+        reset();
+        if (!file_.open(filename)) {
+            event_ = Event::Error;
+            error_message_ = "Cannot open file: " + filename;
+            return false;
+        }
+        data_ = file_.data();
+        size_ = file_.size();
+        return true;
+    }
+
+    void XMLReader::open_buffer(std::string_view content) {
+        reset();
+        data_ = content.data();
+        size_ = content.size();
+    }
+
+    void XMLReader::open_stream(std::istream& stream, size_t chunk_size) {
+        open_source([&stream](char* buffer, size_t size) {
+            stream.read(buffer, static_cast<std::streamsize>(size));
+            return static_cast<size_t>(stream.gcount());
+        }, chunk_size);
+    }
+
+    void XMLReader::open_source(ReadFunction read, size_t chunk_size) {
+        reset();
+        read_ = std::move(read);
+        chunk_size_ = std::max<size_t>(chunk_size, 1);
+        eof_ = false;
+    }
+
+    XMLReader::Event XMLReader::next() {
+        if (event_ == Event::Error) {
+            return event_;
+        }
+
+        if (pending_pop_) {
+            namespaces_.pop();
+            pending_pop_ = false;
+        }
+
+        if (pending_end_) {
+            // Second half of <name/>; name_ and namespace_ still describe the start tag
+            pending_end_ = false;
+            pending_pop_ = namespace_aware_;
+            attributes_.clear();
+            attribute_namespaces_.clear();
+            event_ = Event::EndElement;
+            return event_;
+        }
+
+        name_ = std::string_view();
+        text_ = std::string_view();
+        attributes_.clear();
+        attribute_namespaces_.clear();
+        namespace_ = XMLNamespaceScope::npos;
+        empty_element_ = false;
+
+        const size_t max_document_size = limits_.max_document_size;
+        while (true) {
+            token_offset_ = base_ + pos_;
+            if (max_document_size != 0 && base_ + size_ > max_document_size) {
+                return fail("Maximum document size exceeded", max_document_size > base_ ? max_document_size - base_ : 0);
+            }
+            bool after_root = root_seen_ && open_name_ends_.empty();
+            if (!ensure(1)) {
+                if (after_root) {
+                    depth_ = 0;
+                    event_ = Event::EndDocument;
+                    return event_;
+                }
+                return fail(root_seen_ ? "Unexpected end of input" : "No root element found", size_);
+            }
+
+            if (data_[pos_] != '<') {
+                if (!open_name_ends_.empty()) {
+                    return read_text();
+                }
+                // Outside the root element only whitespace is allowed
+                size_t skipped = 0;
+                detail::skip_whitespace(window(), skipped);
+                pos_ += skipped;
+                if (pos_ < size_ && data_[pos_] != '<') {
+                    return fail(after_root ? "Unexpected content after root element" : "Expected '<' at start of element", pos_);
+                }
+                continue;
+            }
+
+            if (!ensure(2)) {
+                return fail("Unexpected end of input", size_);
+            }
+            char marker = data_[pos_ + 1];
+            if (marker == '!' && open_name_ends_.empty() && ensure(9) && window().compare(0, 9, "<!DOCTYPE") == 0) {
+                if (after_root) {
+                    return fail("Unexpected content after root element", pos_);
+                }
+                if (!skip_doctype()) {
+                    return event_;
+                }
+                continue;
+            }
+            if (marker == '?' || marker == '!') {
+                return read_markup();
+            }
+            if (after_root) {
+                return fail("Unexpected content after root element", pos_);
+            }
+            if (marker == '/') {
+                return read_end_tag();
+            }
+            return read_start_tag();
+        }
+    }
+
+    std::string XMLReader::text() const {
+        if (event_ != Event::Text) {
+            return std::string(text_);
+        }
+        std::string result;
+        detail::decode_entities(text_, result);
+        return result;
+    }
+
+    std::string XMLReader::attribute_value(size_t index) const {
+        std::string result;
+        detail::decode_entities(attributes_[index].value, result);
+        return result;
+    }
+
+    std::string XMLReader::get_attribute(std::string_view attr_name, const std::string& default_value) const {
+        for (size_t i = 0; i < attributes_.size(); ++i) {
+            if (attributes_[i].name == attr_name) {
+                return attribute_value(i);
+            }
+        }
+        return default_value;
+    }
+
+    bool XMLReader::has_attribute(std::string_view attr_name) const {
+        for (const auto& attr : attributes_) {
+            if (attr.name == attr_name) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Private helper methods
+    void XMLReader::reset() {
+        file_.close();
+        read_ = nullptr;
+        buffer_.clear();
+        data_ = nullptr;
+        size_ = 0;
+        pos_ = 0;
+        base_ = 0;
+        eof_ = true;
+        discarded_lines_ = 0;
+        discarded_line_start_ = 0;
+
+        event_ = Event::EndDocument;
+        name_ = std::string_view();
+        text_ = std::string_view();
+        attributes_.clear();
+        depth_ = 0;
+        token_offset_ = 0;
+        empty_element_ = false;
+
+        open_names_.clear();
+        open_name_ends_.clear();
+        pending_end_ = false;
+        root_seen_ = false;
+        doctype_seen_ = false;
+        element_count_ = 0;
+
+        namespaces_.clear();
+        namespace_ = XMLNamespaceScope::npos;
+        attribute_namespaces_.clear();
+        pending_pop_ = false;
+
+        error_message_.clear();
+        error_location_ = ErrorLocation();
+    }
+
+    XMLReader::Event XMLReader::fail(const std::string& message, size_t at) {
+        at = std::min(at, size_);
+
+        // Lines before the window were counted when it was discarded
+        size_t line = discarded_lines_ + 1;
+        size_t line_start = discarded_line_start_;
+        const char* end = data_ + at;
+        const char* cursor = data_;
+        while (cursor < end) {
+            const void* newline = std::memchr(cursor, '\n', end - cursor);
+            if (!newline) {
+                break;
+            }
+            cursor = static_cast<const char*>(newline) + 1;
+            line_start = base_ + static_cast<size_t>(cursor - data_);
+            line++;
+        }
+
+        error_location_.offset = base_ + at;
+        error_location_.line = line;
+        error_location_.column = error_location_.offset - line_start + 1;
+        error_message_ = message + " at " + error_location_.to_string();
+
+        name_ = std::string_view();
+        text_ = std::string_view();
+        attributes_.clear();
+        event_ = Event::Error;
+        return event_;
+    }
+
+    bool XMLReader::fill() {
+        if (eof_) {
+            return false;
+        }
+
+        // Drop the input in front of the current token
+        if (pos_ > 0) {
+            const char* begin = buffer_.data();
+            const char* end = begin + pos_;
+            const char* cursor = begin;
+            while (const void* newline = std::memchr(cursor, '\n', end - cursor)) {
+                cursor = static_cast<const char*>(newline) + 1;
+                discarded_line_start_ = base_ + static_cast<size_t>(cursor - begin);
+                discarded_lines_++;
+            }
+            buffer_.erase(0, pos_);
+            base_ += pos_;
+            pos_ = 0;
+        }
+
+        size_t old_size = buffer_.size();
+        buffer_.resize(old_size + chunk_size_);
+        size_t count = std::min(read_(&buffer_[old_size], chunk_size_), chunk_size_);
+        buffer_.resize(old_size + count);
+        data_ = buffer_.data();
+        size_ = buffer_.size();
+
+        if (count == 0) {
+            eof_ = true;
+            return false;
+        }
+        return true;
+    }
+
+    bool XMLReader::ensure(size_t count) {
+        while (size_ - pos_ < count) {
+            if (!fill()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    size_t XMLReader::find(size_t from, std::string_view delimiter, size_t limit) {
+        size_t scan = from;
+        while (true) {
+            std::string_view current = window();
+            size_t found = current.find(delimiter, scan);
+            if (found != std::string_view::npos || current.size() > limit) {
+                return found;
+            }
+            // The delimiter may straddle the end of the window
+            if (current.size() >= delimiter.size()) {
+                scan = std::max(scan, current.size() - delimiter.size() + 1);
+            }
+            if (!fill()) {
+                return std::string_view::npos;
+            }
+        }
+    }
+
+    XMLReader::Event XMLReader::read_markup() {
+        if (data_[pos_ + 1] == '?') {
+            size_t end = find(2, "?>");
+            if (end == std::string_view::npos) {
+                return fail("Unterminated processing instruction", size_);
+            }
+            std::string_view body = window().substr(2, end - 2);
+            size_t target_end = 0;
+            while (target_end < body.size() && !detail::is_space(body[target_end])) {
+                target_end++;
+            }
+            size_t data_start = target_end;
+            detail::skip_whitespace(body, data_start);
+            name_ = body.substr(0, target_end);
+            text_ = body.substr(data_start);
+            depth_ = open_name_ends_.size();
+            pos_ += end + 2;
+            event_ = Event::ProcessingInstruction;
+            return event_;
+        }
+
+        if (ensure(4) && window().compare(0, 4, "<!--") == 0) {
+            size_t end = find(4, "-->");
+            if (end == std::string_view::npos) {
+                return fail("Unterminated comment", size_);
+            }
+            text_ = window().substr(4, end - 4);
+            depth_ = open_name_ends_.size();
+            pos_ += end + 3;
+            event_ = Event::Comment;
+            return event_;
+        }
+
+        if (ensure(9) && window().compare(0, 9, "<![CDATA[") == 0) {
+            if (open_name_ends_.empty()) {
+                return fail("CDATA section outside of root element", pos_);
+            }
+            const size_t max_text_size = limits_.max_text_size;
+            size_t limit = max_text_size != 0 ? max_text_size + 9 : std::string_view::npos;
+            size_t end = find(9, "]]>", limit);
+            if (max_text_size != 0 && (end == std::string_view::npos ? size_ - pos_ : end) > limit) {
+                return fail("Maximum text size exceeded", pos_ + limit);
+            }
+            if (end == std::string_view::npos) {
+                return fail("Unterminated CDATA section", size_);
+            }
+            text_ = window().substr(9, end - 9);
+            depth_ = open_name_ends_.size();
+            pos_ += end + 3;
+            event_ = Event::CData;
+            return event_;
+        }
+
+        return fail("Unsupported markup declaration", pos_);
+    }
+
+    bool XMLReader::skip_doctype() {
+        if (doctype_seen_) {
+            fail("Multiple DOCTYPE declarations", pos_);
+            return false;
+        }
+
+        size_t scan = 9; // Skip "<!DOCTYPE"
+        bool in_subset = false;
+        size_t end;
+        while ((end = detail::find_doctype_end(window(), scan, in_subset)) == std::string_view::npos) {
+            if (!fill()) {
+                fail("Unterminated DOCTYPE declaration", pos_);
+                return false;
+            }
+        }
+        pos_ += end + 1;
+        doctype_seen_ = true;
+        return true;
+    }
+
+    XMLReader::Event XMLReader::read_start_tag() {
+        // Locate the closing '>' first, so the whole tag is in the window
+        size_t end;
+        size_t scan = 1;
+        char quote = 0;
+        while (true) {
+            std::string_view current = window();
+            end = detail::find_tag_end(current, scan, quote);
+            if (end != std::string_view::npos) {
+                break;
+            }
+            scan = current.size();
+            if (!fill()) {
+                return fail(quote ? "Unterminated attribute value" : "Unexpected end of input", size_);
+            }
+        }
+
+        std::string_view tag = window().substr(0, end + 1);
+        size_t pos = 1;
+        std::string_view name = detail::scan_element_name(tag, pos);
+        if (name.empty()) {
+            return fail("Failed to parse element tag", pos_ + pos);
+        }
+
+        const XMLLimits& limits = limits_;
+        if (limits.max_depth != 0 && open_name_ends_.size() >= limits.max_depth) {
+            return fail("Maximum depth exceeded", pos_);
+        }
+        if (limits.max_elements != 0 && ++element_count_ > limits.max_elements) {
+            return fail("Maximum element count exceeded", pos_);
+        }
+        if (limits.max_name_length != 0 && name.size() > limits.max_name_length) {
+            return fail("Maximum name length exceeded", pos_ + 1);
+        }
+
+        // The tag ends with '>', so the scans below stay inside it
+        while (true) {
+            detail::skip_whitespace(tag, pos);
+            if (tag[pos] == '>' || tag[pos] == '/') {
+                break;
+            }
+            if (limits.max_attributes != 0 && attributes_.size() >= limits.max_attributes) {
+                return fail("Maximum attribute count exceeded", pos_ + pos);
+            }
+            size_t attr_pos = pos;
+            Attribute attr;
+            if (const char* error = detail::scan_attribute(tag, pos, attr.name, attr.value)) {
+                return fail(error, pos_ + pos);
+            }
+            if (limits.max_name_length != 0 && attr.name.size() > limits.max_name_length) {
+                return fail("Maximum name length exceeded", pos_ + attr_pos);
+            }
+            if (limits.max_text_size != 0 && attr.value.size() > limits.max_text_size) {
+                return fail("Maximum text size exceeded", pos_ + attr_pos);
+            }
+            attributes_.push_back(attr);
+        }
+
+        if (tag[pos] == '/') {
+            pos++; // Skip '/'
+            detail::skip_whitespace(tag, pos);
+            if (tag[pos] != '>') {
+                return fail("Expected '>' after '/' in self-closing tag", pos_ + pos);
+            }
+            empty_element_ = true;
+            pending_end_ = true;
+        } else {
+            open_names_.append(name.data(), name.size());
+            open_name_ends_.push_back(open_names_.size());
+        }
+
+        name_ = name;
+        if (namespace_aware_ && !resolve_namespaces()) {
+            return event_;
+        }
+        depth_ = open_name_ends_.size() + (empty_element_ ? 1 : 0);
+        root_seen_ = true;
+        pos_ += end + 1;
+        event_ = Event::StartElement;
+        return event_;
+    }
+
+    XMLReader::Event XMLReader::read_end_tag() {
+        if (open_name_ends_.empty()) {
+            return fail("Unexpected closing tag", pos_ + 1);
+        }
+
+        size_t end = find(2, ">");
+        if (end == std::string_view::npos) {
+            return fail("Unterminated closing tag", size_);
+        }
+
+        std::string_view closing_name = detail::trim(window().substr(2, end - 2));
+        size_t name_start = open_name_ends_.size() > 1 ? open_name_ends_[open_name_ends_.size() - 2] : 0;
+        std::string_view expected = std::string_view(open_names_).substr(name_start);
+        if (closing_name != expected) {
+            return fail("Mismatched closing tag: expected '" + std::string(expected) + "', got '" + std::string(closing_name) + "'", pos_ + 2);
+        }
+
+        if (namespace_aware_) {
+            // The scope is closed on the next call, so the element keeps its namespace
+            namespaces_.resolve(XMLNamespaceScope::prefix(closing_name), namespace_);
+            pending_pop_ = true;
+        }
+
+        depth_ = open_name_ends_.size();
+        open_name_ends_.pop_back();
+        open_names_.resize(name_start);
+
+        name_ = closing_name;
+        pos_ += end + 1;
+        event_ = Event::EndElement;
+        return event_;
+    }
+
+    bool XMLReader::resolve_namespaces() {
+        namespaces_.push();
+        for (const auto& attr : attributes_) {
+            std::string_view prefix;
+            if (!XMLNamespaceScope::is_declaration(attr.name, prefix)) {
+                continue;
+            }
+            std::string_view uri = attr.value;
+            if (uri.find('&') != std::string_view::npos) {
+                decoded_uri_.clear();
+                detail::decode_entities(uri, decoded_uri_);
+                uri = decoded_uri_;
+            }
+            if (const char* error = namespaces_.bind(prefix, uri)) {
+                fail(error, pos_);
+                return false;
+            }
+        }
+
+        if (!namespaces_.resolve(XMLNamespaceScope::prefix(name_), namespace_)) {
+            fail("Unbound namespace prefix '" + std::string(XMLNamespaceScope::prefix(name_)) + "'", pos_);
+            return false;
+        }
+
+        attribute_namespaces_.resize(attributes_.size());
+        for (size_t i = 0; i < attributes_.size(); ++i) {
+            std::string_view attr_name = attributes_[i].name;
+            std::string_view prefix = XMLNamespaceScope::prefix(attr_name);
+            if (prefix.empty()) {
+                // Unprefixed attributes have no namespace, except xmlns itself
+                attribute_namespaces_[i] = XMLNamespaceScope::npos;
+                if (attr_name == "xmlns") {
+                    namespaces_.resolve("xmlns", attribute_namespaces_[i]);
+                }
+            } else if (!namespaces_.resolve(prefix, attribute_namespaces_[i])) {
+                fail("Unbound namespace prefix '" + std::string(prefix) + "'", pos_);
+                return false;
+            }
+        }
+
+        // Different prefixes can name the same attribute once resolved
+        for (size_t i = 0; i < attributes_.size(); ++i) {
+            uint32_t uri = attribute_namespaces_[i];
+            if (uri == XMLNamespaceScope::npos) {
+                continue;
+            }
+            std::string_view local_name = attribute_local_name(i);
+            for (size_t j = 0; j < i; ++j) {
+                if (attribute_namespaces_[j] == uri && attribute_local_name(j) == local_name) {
+                    fail("Duplicate attribute '" + std::string(local_name) + "' in namespace '" +
+                         std::string(namespaces_.uri(uri)) + "'", pos_);
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    XMLReader::Event XMLReader::read_text() {
+        const size_t max_text_size = limits_.max_text_size;
+        size_t limit = max_text_size != 0 ? max_text_size : std::string_view::npos;
+        size_t end = find(0, "<", limit);
+        if (max_text_size != 0 && (end == std::string_view::npos ? size_ - pos_ : end) > limit) {
+            return fail("Maximum text size exceeded", pos_ + limit);
+        }
+        if (end == std::string_view::npos) {
+            return fail("Unexpected end of input", size_);
+        }
+        text_ = window().substr(0, end);
+        depth_ = open_name_ends_.size();
+        pos_ += end;
+        event_ = Event::Text;
+        return event_;
+    }
+
+} // namespace parser
@@ -0,0 +1,325 @@
+#include "parsers/xml_scanner.h"
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+
+namespace parser {
+namespace detail {
+
+    namespace {
+
+        // Longest reference we decode: "&#x10FFFF;" without the '&'
+        constexpr size_t kMaxEntityLength = 9;
+
+        template <typename String>
+        void append_utf8(uint32_t code_point, String& out) {
+            if (code_point < 0x80) {
+                out += static_cast<char>(code_point);
+            } else if (code_point < 0x800) {
+                out += static_cast<char>(0xc0 | (code_point >> 6));
+                out += static_cast<char>(0x80 | (code_point & 0x3f));
+            } else if (code_point < 0x10000) {
+                out += static_cast<char>(0xe0 | (code_point >> 12));
+                out += static_cast<char>(0x80 | ((code_point >> 6) & 0x3f));
+                out += static_cast<char>(0x80 | (code_point & 0x3f));
+            } else {
+                out += static_cast<char>(0xf0 | (code_point >> 18));
+                out += static_cast<char>(0x80 | ((code_point >> 12) & 0x3f));
+                out += static_cast<char>(0x80 | ((code_point >> 6) & 0x3f));
+                out += static_cast<char>(0x80 | (code_point & 0x3f));
+            }
+        }
+
+        // Parses the part after "&#", e.g. "x41" or "65"
+        template <typename String>
+        bool decode_char_ref(std::string_view ref, String& out) {
+            uint32_t base = 10;
+            if (!ref.empty() && (ref[0] == 'x' || ref[0] == 'X')) {
+                base = 16;
+                ref.remove_prefix(1);
+            }
+            if (ref.empty()) {
+                return false;
+            }
+
+            uint32_t code_point = 0;
+            for (char c : ref) {
+                uint32_t digit;
+                if (c >= '0' && c <= '9') {
+                    digit = static_cast<uint32_t>(c - '0');
+                } else if (base == 16 && c >= 'a' && c <= 'f') {
+                    digit = static_cast<uint32_t>(c - 'a' + 10);
+                } else if (base == 16 && c >= 'A' && c <= 'F') {
+                    digit = static_cast<uint32_t>(c - 'A' + 10);
+                } else {
+                    return false;
+                }
+                code_point = code_point * base + digit;
+                if (code_point > 0x10ffff) {
+                    return false;
+                }
+            }
+
+            if (code_point == 0 || (code_point >= 0xd800 && code_point <= 0xdfff)) {
+                return false;
+            }
+            append_utf8(code_point, out);
+            return true;
+        }
+
+        const char* entity_for(char c) {
+            switch (c) {
+                case '&': return "&amp;";
+                case '<': return "&lt;";
+                case '>': return "&gt;";
+                case '"': return "&quot;";
+                default: return "";
+            }
+        }
+
+        template <typename... Chars>
+        void escape(std::string_view text, std::string& out, Chars... specials) {
+            const char* pos = text.data();
+            const char* end = pos + text.size();
+            out.reserve(out.size() + text.size());
+
+            while (pos < end) {
+                const char* special = find_any(pos, end, specials...);
+                out.append(pos, special);
+                if (special == end) {
+                    return;
+                }
+                out += entity_for(*special);
+                pos = special + 1;
+            }
+        }
+
+        template <typename String>
+        bool decode_entity(std::string_view name, String& out) {
+            switch (name.size()) {
+                case 2:
+                    if (name == "lt") { out += '<'; return true; }
+                    if (name == "gt") { out += '>'; return true; }
+                    break;
+                case 3:
+                    if (name == "amp") { out += '&'; return true; }
+                    break;
+                case 4:
+                    if (name == "quot") { out += '"'; return true; }
+                    if (name == "apos") { out += '\''; return true; }
+                    break;
+                default:
+                    break;
+            }
+            if (!name.empty() && name[0] == '#') {
+                return decode_char_ref(name.substr(1), out);
+            }
+            return false;
+        }
+
+        template <typename String>
+        void decode_entities_into(std::string_view text, String& out) {
+            const char* pos = text.data();
+            const char* end = pos + text.size();
+            out.reserve(out.size() + text.size());
+
+            while (pos < end) {
+                // Copy the entity-free run in one go
+                const char* amp = static_cast<const char*>(std::memchr(pos, '&', end - pos));
+                if (!amp) {
+                    out.append(pos, end);
+                    return;
+                }
+                out.append(pos, amp);
+
+                size_t window = std::min<size_t>(end - amp - 1, kMaxEntityLength);
+                const char* semi = static_cast<const char*>(std::memchr(amp + 1, ';', window));
+                if (semi && decode_entity(std::string_view(amp + 1, semi - amp - 1), out)) {
+                    pos = semi + 1;
+                } else {
+                    out += '&';
+                    pos = amp + 1;
+                }
+            }
+        }
+
+        template <typename String>
+        size_t scan_text_into(std::string_view content, size_t pos, String& out) {
+            const char* data = content.data();
+            const char* end = data + content.size();
+            const char* start = data + std::min(pos, content.size());
+
+            const char* special = find_any(start, end, '<', '&');
+            if (special == end || *special == '<') {
+                out.append(start, special);
+                return static_cast<size_t>(special - data);
+            }
+
+            const char* text_end = static_cast<const char*>(std::memchr(special, '<', end - special));
+            if (!text_end) {
+                text_end = end;
+            }
+            out.append(start, special);
+            decode_entities_into(std::string_view(special, text_end - special), out);
+            return static_cast<size_t>(text_end - data);
+        }
+
+    } // namespace
+
+    std::string_view scan_element_name(std::string_view content, size_t& pos) {
+        size_t start = pos;
+        while (pos < content.size() && !has_class(content[pos], kElementNameEnd)) {
+            pos++;
+        }
+        return content.substr(start, pos - start);
+    }
+
+    const char* scan_attribute(std::string_view content, size_t& pos, std::string_view& name, std::string_view& raw_value) {
+        size_t name_start = pos;
+        while (pos < content.size() && !has_class(content[pos], kAttributeNameEnd)) {
+            pos++;
+        }
+        if (pos == name_start) {
+            return "Invalid attribute name";
+        }
+        name = content.substr(name_start, pos - name_start);
+
+        skip_whitespace(content, pos);
+        if (pos >= content.size() || content[pos] != '=') {
+            return "Expected '=' after attribute name";
+        }
+        pos++; // Skip '='
+        skip_whitespace(content, pos);
+
+        if (pos >= content.size()) {
+            return "Unexpected end of input in attribute";
+        }
+        char quote = content[pos];
+        if (quote != '"' && quote != '\'') {
+            return "Expected quote in attribute value";
+        }
+        pos++; // Skip opening quote
+
+        size_t value_end = content.find(quote, pos);
+        if (value_end == std::string_view::npos) {
+            pos = content.size();
+            return "Unterminated attribute value";
+        }
+        raw_value = content.substr(pos, value_end - pos);
+        pos = value_end + 1; // Skip closing quote
+        return nullptr;
+    }
+
+    size_t find_tag_end(std::string_view content, size_t pos, char& quote) {
+        const char* data = content.data();
+        const char* end = data + content.size();
+        const char* cursor = data + std::min(pos, content.size());
+
+        while (cursor < end) {
+            if (quote != 0) {
+                cursor = static_cast<const char*>(std::memchr(cursor, quote, end - cursor));
+                if (!cursor) {
+                    return std::string_view::npos;
+                }
+                quote = 0;
+                ++cursor;
+                continue;
+            }
+            cursor = find_any(cursor, end, '>', '"', '\'');
+            if (cursor == end) {
+                break;
+            }
+            if (*cursor == '>') {
+                return static_cast<size_t>(cursor - data);
+            }
+            quote = *cursor++;
+        }
+        return std::string_view::npos;
+    }
+
+    size_t find_doctype_end(std::string_view content, size_t& pos, bool& in_subset) {
+        const char* data = content.data();
+        const char* end = data + content.size();
+        const char* cursor = data + std::min(pos, content.size());
+
+        while (true) {
+            // Everything before the cursor has been scanned completely
+            pos = static_cast<size_t>(cursor - data);
+            cursor = in_subset ? find_any(cursor, end, ']', '<', '"', '\'')
+                               : find_any(cursor, end, '>', '[', '"', '\'');
+            if (cursor == end) {
+                pos = content.size();
+                return std::string_view::npos;
+            }
+
+            size_t at = static_cast<size_t>(cursor - data);
+            size_t body = at + 1;
+            std::string_view terminator;
+            switch (*cursor) {
+                case '>':
+                    return at;
+                case '[':
+                    in_subset = true;
+                    ++cursor;
+                    continue;
+                case ']':
+                    in_subset = false;
+                    ++cursor;
+                    continue;
+                case '<':
+                    if (end - cursor < 4) {
+                        // Possibly the start of a comment cut off by the end of the input
+                        pos = at;
+                        return std::string_view::npos;
+                    }
+                    if (content.compare(at, 4, "<!--") == 0) {
+                        body = at + 4;
+                        terminator = "-->";
+                    } else if (cursor[1] == '?') {
+                        body = at + 2;
+                        terminator = "?>";
+                    } else {
+                        ++cursor;
+                        continue;
+                    }
+                    break;
+                default:
+                    terminator = std::string_view(cursor, 1);
+                    break;
+            }
+
+            size_t close = content.find(terminator, body);
+            if (close == std::string_view::npos) {
+                pos = at;
+                return std::string_view::npos;
+            }
+            cursor = data + close + terminator.size();
+        }
+    }
+
+    size_t scan_text(std::string_view content, size_t pos, std::string& out) {
+        return scan_text_into(content, pos, out);
+    }
+
+    size_t scan_text(std::string_view content, size_t pos, std::pmr::string& out) {
+        return scan_text_into(content, pos, out);
+    }
+
+    void decode_entities(std::string_view text, std::string& out) {
+        decode_entities_into(text, out);
+    }
+
+    void decode_entities(std::string_view text, std::pmr::string& out) {
+        decode_entities_into(text, out);
+    }
+
+    void escape_text(std::string_view text, std::string& out) {
+        escape(text, out, '&', '<', '>');
+    }
+
+    void escape_attribute(std::string_view text, std::string& out) {
+        escape(text, out, '&', '<', '>', '"');
+    }
+
+} // namespace detail
+} // namespace parser
@@ -0,0 +1,341 @@
+#include "parsers/xml_writer.h"
+#include "parsers/xml_scanner.h"
+#include <algorithm>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace parser {
+
+    XMLWriter::~XMLWriter() {
+        close();
+    }
+
+    bool XMLWriter::open(const std::string& filename) {
+        reset();
+#ifdef _WIN32
+        int fd = _open(filename.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+        int fd = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+#endif
+        if (fd < 0) {
+            return false;
+        }
+        sink_ = Sink::File;
+        fd_ = fd;
+        owns_fd_ = true;
+        return true;
+    }
+
+    void XMLWriter::open_buffer(std::string& out) {
+        reset();
+        out_ = &out;
+    }
+
+    void XMLWriter::open_stream(std::ostream& stream) {
+        reset();
+        sink_ = Sink::Stream;
+        stream_ = &stream;
+    }
+
+    void XMLWriter::open_fd(int fd) {
+        reset();
+        sink_ = Sink::File;
+        fd_ = fd;
+    }
+
+    void XMLWriter::declaration() {
+        if (written_ || !open_.empty()) {
+            fail("XML declaration must come first");
+            return;
+        }
+        begin_child(false);
+        *out_ += "<?xml version=\"1.0\" encoding=\"UTF-8\"?>";
+        maybe_flush();
+    }
+
+    void XMLWriter::start_element(std::string_view name) {
+        begin_child(false);
+        bool inline_content = !open_.empty() && open_.back().inline_content;
+
+        *out_ += '<';
+        out_->append(name.data(), name.size());
+        start_tag_open_ = true;
+
+        open_names_.append(name.data(), name.size());
+        open_.push_back(OpenElement{open_names_.size(), false, inline_content});
+        maybe_flush();
+    }
+
+    void XMLWriter::attribute(std::string_view name, std::string_view value) {
+        if (!start_tag_open_) {
+            fail("Attribute written outside a start tag");
+            return;
+        }
+        *out_ += ' ';
+        out_->append(name.data(), name.size());
+        *out_ += "=\"";
+        detail::escape_attribute(value, *out_);
+        *out_ += '"';
+        maybe_flush();
+    }
+
+    void XMLWriter::text(std::string_view text) {
+        if (text.empty()) {
+            return;
+        }
+        begin_child(true);
+        detail::escape_text(text, *out_);
+        maybe_flush();
+    }
+
+    void XMLWriter::raw(std::string_view markup) {
+        if (markup.empty()) {
+            return;
+        }
+        begin_child(true);
+        out_->append(markup.data(), markup.size());
+        maybe_flush();
+    }
+
+    void XMLWriter::cdata(std::string_view data) {
+        begin_child(true);
+        *out_ += "<![CDATA[";
+        out_->append(data.data(), data.size());
+        *out_ += "]]>";
+        maybe_flush();
+    }
+
+    void XMLWriter::comment(std::string_view data) {
+        begin_child(false);
+        *out_ += "<!--";
+        out_->append(data.data(), data.size());
+        *out_ += "-->";
+        maybe_flush();
+    }
+
+    void XMLWriter::processing_instruction(std::string_view target, std::string_view data) {
+        begin_child(false);
+        *out_ += "<?";
+        out_->append(target.data(), target.size());
+        if (!data.empty()) {
+            *out_ += ' ';
+            out_->append(data.data(), data.size());
+        }
+        *out_ += "?>";
+        maybe_flush();
+    }
+
+    void XMLWriter::end_element() {
+        if (open_.empty()) {
+            fail("No open element to close");
+            return;
+        }
+
+        OpenElement element = open_.back();
+        open_.pop_back();
+        size_t name_start = open_.empty() ? 0 : open_.back().name_end;
+
+        if (start_tag_open_) {
+            *out_ += " />";
+            start_tag_open_ = false;
+        } else {
+            if (element.has_children && !element.inline_content && indent_ > 0) {
+                *out_ += '\n';
+                out_->append(open_.size() * indent_, ' ');
+            }
+            *out_ += "</";
+            out_->append(open_names_, name_start, element.name_end - name_start);
+            *out_ += '>';
+        }
+        open_names_.resize(name_start);
+        maybe_flush();
+    }
+
+    void XMLWriter::write_node(const XMLNode& node) {
+        struct Frame {
+            const XMLNode* node;
+            size_t next_child;
+        };
+        // Explicit stack, so deep trees cannot exhaust the call stack
+        std::vector<Frame> stack;
+
+        auto open_node = [&](const XMLNode& current) {
+            if (!current.is_element()) {
+                write_content(current);
+                return;
+            }
+
+            start_element(current.name);
+            for (const auto& attr : current.attributes) {
+                attribute(attr.name, attr.value);
+            }
+
+            bool has_content = std::any_of(current.children.begin(), current.children.end(), [](const XMLNode& child) {
+                return !child.is_element();
+            });
+            if (has_content) {
+                // Mixed content is written as parsed; added whitespace would change it
+                open_.back().inline_content = true;
+            } else {
+                text(current.value);
+            }
+
+            if (current.children.empty()) {
+                end_element();
+            } else {
+                stack.push_back(Frame{&current, 0});
+            }
+        };
+
+        open_node(node);
+        while (!stack.empty()) {
+            Frame& top = stack.back();
+            if (top.next_child == top.node->children.size()) {
+                stack.pop_back();
+                end_element();
+                continue;
+            }
+            open_node(top.node->children[top.next_child++]);
+        }
+    }
+
+    bool XMLWriter::flush() {
+        if (sink_ == Sink::Buffer || buffer_.empty()) {
+            return good();
+        }
+
+        if (good()) {
+            if (sink_ == Sink::Stream) {
+                stream_->write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+                if (!*stream_) {
+                    fail("Failed to write to stream");
+                }
+            } else {
+                const char* data = buffer_.data();
+                size_t remaining = buffer_.size();
+                while (remaining > 0) {
+#ifdef _WIN32
+                    unsigned int chunk = static_cast<unsigned int>(std::min<size_t>(remaining, 1u << 30));
+                    int written = _write(fd_, data, chunk);
+#else
+                    ssize_t written = ::write(fd_, data, remaining);
+                    if (written < 0 && errno == EINTR) {
+                        continue;
+                    }
+#endif
+                    if (written <= 0) {
+                        fail("Failed to write to file");
+                        break;
+                    }
+                    data += written;
+                    remaining -= static_cast<size_t>(written);
+                }
+            }
+        }
+
+        // Dropped after a failure too, so memory stays bounded
+        buffer_.clear();
+        return good();
+    }
+
+    bool XMLWriter::close() {
+        bool ok = flush();
+        if (sink_ == Sink::Stream && ok) {
+            stream_->flush();
+        }
+        if (owns_fd_) {
+#ifdef _WIN32
+            bool closed = _close(fd_) == 0;
+#else
+            bool closed = ::close(fd_) == 0;
+#endif
+            if (!closed) {
+                fail("Failed to close file");
+                ok = false;
+            }
+            owns_fd_ = false;
+            fd_ = -1;
+            sink_ = Sink::Buffer;
+        }
+        return ok;
+    }
+
+    void XMLWriter::reset() {
+        close();
+        sink_ = Sink::Buffer;
+        buffer_.clear();
+        out_ = &buffer_;
+        stream_ = nullptr;
+        fd_ = -1;
+        start_tag_open_ = false;
+        written_ = false;
+        error_.clear();
+        open_names_.clear();
+        open_.clear();
+    }
+
+    void XMLWriter::fail(const char* message) {
+        if (error_.empty()) {
+            error_ = message;
+        }
+    }
+
+    void XMLWriter::close_start_tag() {
+        if (start_tag_open_) {
+            *out_ += '>';
+            start_tag_open_ = false;
+        }
+    }
+
+    void XMLWriter::begin_child(bool is_text) {
+        if (open_.empty()) {
+            if (written_ && indent_ > 0 && !is_text) {
+                *out_ += '\n';
+            }
+            written_ = true;
+            return;
+        }
+
+        close_start_tag();
+        OpenElement& parent = open_.back();
+        if (is_text) {
+            parent.inline_content = true;
+        } else if (!parent.inline_content && indent_ > 0) {
+            *out_ += '\n';
+            out_->append(open_.size() * indent_, ' ');
+        }
+        parent.has_children = true;
+    }
+
+    void XMLWriter::write_content(const XMLNode& node) {
+        switch (node.type) {
+            case XMLNode::Type::CData:
+                cdata(node.raw());
+                break;
+            case XMLNode::Type::Comment:
+                comment(node.raw());
+                break;
+            case XMLNode::Type::ProcessingInstruction:
+                processing_instruction(node.raw());
+                break;
+            default:
+                raw(node.raw());
+                break;
+        }
+    }
+
+    void XMLWriter::maybe_flush() {
+        if (sink_ != Sink::Buffer && buffer_.size() >= kFlushSize) {
+            flush();
+        }
+    }
+
+} // namespace parser
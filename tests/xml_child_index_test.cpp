@@ -0,0 +1,62 @@
+// Checks that child lookups follow edits to the children, and that
+// XMLChildIndex finds children by name in document order.
+//
+// Build and run from the repository root:
+//   g++ -std=c++17 -Iinclude tests/xml_child_index_test.cpp src/parsers/*.cpp -pthread -o xml_child_index_test
+//   ./xml_child_index_test
+
+#include <iostream>
+#include <string>
+#include "parsers/xml_parser.h"
+
+using namespace parser;
+
+namespace {
+
+    int failures = 0;
+
+    void check(bool condition, const char* what) {
+        if (!condition) {
+            std::cout << "FAILED: " << what << std::endl;
+            ++failures;
+        }
+    }
+
+} // namespace
+
+int main() {
+    XMLParser parser;
+    std::string xml = "<r>";
+    for (int i = 0; i < 40; ++i) {
+        xml += "<c" + std::to_string(i) + ">" + std::to_string(i) + "</c" + std::to_string(i) + ">";
+    }
+    xml += "</r>";
+    XMLResult result = parser.parse(xml);
+    check(result.success, "parse");
+
+    // Renaming a child in place is seen by the next lookup
+    XMLNode& root = result.root;
+    check(root.get_child("c5") == &root.children[5], "get_child before renaming");
+    root.children[3].name = "c5";
+    check(root.get_child("c5") == &root.children[3], "get_child after renaming");
+    check(root.get_children("c5").size() == 2, "get_children after renaming");
+    check(root.get_child("c3") == nullptr, "old name after renaming");
+
+    XMLChildIndex index(root);
+    check(index.find("c5") == &root.children[3], "index finds the first in document order");
+    auto all = index.find_all("c5");
+    check(all.size() == 2 && all[0] == &root.children[3] && all[1] == &root.children[5], "index finds all in document order");
+    check(index.find("c39") == &root.children[39], "index finds the last child");
+    check(index.find("missing") == nullptr, "index misses absent names");
+
+    // Adding a child sends lookups back to a scan
+    XMLNode added;
+    added.name = "c40";
+    root.add_child(added);
+    check(index.find("c40") == &root.children[40], "index after adding a child");
+
+    if (failures == 0) {
+        std::cout << "all passed" << std::endl;
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,63 @@
+// Checks that XMLPathCache never hands out nodes of a tree its result no
+// longer holds: after reassigning, copying into or moving out of the result.
+//
+// Build and run from the repository root:
+//   g++ -std=c++17 -Iinclude tests/xml_path_cache_test.cpp src/parsers/*.cpp -pthread -o xml_path_cache_test
+//   ./xml_path_cache_test
+
+#include <iostream>
+#include <string>
+#include "parsers/xml_parser.h"
+
+using namespace parser;
+
+namespace {
+
+    int failures = 0;
+
+    void check(bool condition, const char* what) {
+        if (!condition) {
+            std::cout << "FAILED: " << what << std::endl;
+            ++failures;
+        }
+    }
+
+    std::string value_of(const XMLNode* node) {
+        return node ? std::string(node->value) : std::string("<none>");
+    }
+
+} // namespace
+
+int main() {
+    XMLParser parser;
+    XMLPathCache cache;
+
+    // The new tree may live at the same address as the old one
+    XMLResult result = parser.parse("<r><a>1</a></r>");
+    check(value_of(cache.resolve(result, "a")) == "1", "first tree");
+    result = parser.parse("<r><a>2</a></r>");
+    check(value_of(cache.resolve(result, "a")) == "2", "tree assigned by parse");
+    check(cache.resolve(result, "a") == XMLPath::resolve(result.root, "a"), "entry points into the current tree");
+
+    XMLResult other = parser.parse("<r><a>3</a></r>");
+    check(value_of(cache.resolve(other, "a")) == "3", "another result");
+    result = other;
+    check(value_of(cache.resolve(result, "a")) == "3", "tree assigned by copy");
+    check(cache.resolve(result, "a") != cache.resolve(other, "a"), "copy and original are distinct trees");
+
+    XMLResult moved = std::move(result);
+    check(value_of(cache.resolve(moved, "a")) == "3", "moved-to result");
+    check(cache.resolve(result, "a") == nullptr, "moved-from result");
+
+    // Edits to the nodes are the caller's to report
+    XMLNode* a = moved.root.get_child("a");
+    check(cache.resolve(moved, "a") == a, "cached node");
+    moved.root.children.clear();
+    cache.clear();
+    check(cache.resolve(moved, "a") == nullptr, "after clear");
+
+    if (failures == 0) {
+        std::cout << "all passed" << std::endl;
+    }
+    return failures == 0 ? 0 : 1;
+}
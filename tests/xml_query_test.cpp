@@ -0,0 +1,74 @@
+// Checks that XMLQuery reports // matches in document order, counts [n]
+// within each parent, and reports each node once when // steps nest.
+//
+// Build and run from the repository root:
+//   g++ -std=c++17 -Iinclude tests/xml_query_test.cpp src/parsers/*.cpp -pthread -o xml_query_test
+//   ./xml_query_test
+
+#include <iostream>
+#include <string>
+#include "parsers/xml_parser.h"
+#include "parsers/xml_query.h"
+
+using namespace parser;
+
+namespace {
+
+    int failures = 0;
+
+    void check(bool condition, const char* what) {
+        if (!condition) {
+            std::cout << "FAILED: " << what << std::endl;
+            ++failures;
+        }
+    }
+
+    // Values of all matches, comma separated
+    std::string values_of(const XMLResult& result, const std::string& expression) {
+        XMLQuery query = XMLQuery::compile(expression);
+        if (!query.success) {
+            return "<" + query.error_message + ">";
+        }
+        std::string values;
+        auto range = query.select(result);
+        for (auto it = range.begin(); it != range.end(); ++it) {
+            values += values.empty() ? "" : ",";
+            values += std::string(it.value());
+        }
+        return values;
+    }
+
+} // namespace
+
+int main() {
+    XMLParser parser;
+
+    XMLResult nested = parser.parse("<r><a><a><b>1</b></a><b>2</b></a><c><b>3</b></c></r>");
+    check(values_of(nested, "//b") == "1,2,3", "//b in document order");
+    check(values_of(nested, "/r//b") == "1,2,3", "/r//b in document order");
+    check(values_of(nested, "//b/text()") == "1,2,3", "//b/text() in document order");
+    check(XMLQuery::compile("//b").first_value(nested.root) == "1", "first_value is the first in the document");
+    check(values_of(nested, "//a//b") == "1,2", "nested // reports each node once");
+    check(values_of(nested, "//*//b") == "1,2,3", "// under any element reports each node once");
+    check(values_of(nested, "//r") == "", "root element has no text");
+    check(XMLQuery::compile("//r").first(nested.root) == &nested.root, "//r matches the root element");
+
+    XMLResult lists = parser.parse("<r><x><b>1</b><y><b>2</b><b>3</b></y><b>4</b></x></r>");
+    check(values_of(lists, "//b[2]") == "3,4", "[n] counts within each parent");
+    check(values_of(lists, "//b[1]") == "1,2", "[1] of each parent");
+    check(values_of(lists, "//b[3]") == "", "[n] past the last sibling");
+
+    XMLResult inner_first = parser.parse("<r><x><x><b>3</b><b>4</b></x><b>1</b><b>2</b></x></r>");
+    check(values_of(inner_first, "//b[2]") == "4,2", "[n] matches in document order");
+    check(values_of(inner_first, "//x//b[1]") == "3,1", "nested // with [n]");
+
+    XMLResult attributes = parser.parse("<r><i id='1'><i id='2'/></i><i id='3'/></r>");
+    check(values_of(attributes, "//i/@id") == "1,2,3", "//i/@id in document order");
+    check(values_of(attributes, "//@id") == "1,2,3", "//@id in document order");
+    check(values_of(attributes, "//i[@id='2']/@id") == "2", "attribute predicate on //");
+
+    if (failures == 0) {
+        std::cout << "all passed" << std::endl;
+    }
+    return failures == 0 ? 0 : 1;
+}